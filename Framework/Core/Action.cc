@@ -1,4 +1,5 @@
 #include "Action.hh"
+#include "Log.hh"
 #include <iostream>
 #include <sstream>
 
@@ -16,7 +17,7 @@ bool Action::command(int unit_id, int direction) {
 bool Action::command(const Movement& movement) {
     // Verificar si la unitat ja ha actuat aquesta ronda
     if (units_acted_.find(movement.unit_id) != units_acted_.end()) {
-        std::cerr << "warning: action already requested for unit " << movement.unit_id << std::endl;
+        LOG_WARNING("action already requested for unit " << movement.unit_id);
         return false;
     }
     
@@ -83,7 +84,7 @@ void Action::read(std::istream& is) {
             int direction = charToDirection(direction_char);
             command(unit_id, direction);
         } else {
-            std::cerr << "warning: only half an operation given for unit " << unit_id << std::endl;
+            LOG_WARNING("only half an operation given for unit " << unit_id);
             return;
         }
     }
@@ -1,6 +1,7 @@
 #include "Board.hh"
 #include <fstream>
 #include <sstream>
+#include "Log.hh"
 #include <iostream>
 #include <algorithm>
 
@@ -15,7 +16,7 @@ Board::Board(std::shared_ptr<GameDefinition> def)
 bool Board::loadFromFile(const std::string& filename) {
     std::ifstream file(filename);
     if (!file.is_open()) {
-        std::cerr << "Error: No s'ha pogut obrir el fitxer " << filename << std::endl;
+        LOG_ERROR("No s'ha pogut obrir el fitxer " << filename);
         return false;
     }
     
@@ -39,11 +40,11 @@ bool Board::parseMapFile(std::istream& is) {
     iss >> game_name >> version;
     
     // Debug: imprimir el que hem llegit
-    std::cerr << "Debug: llegint mapa - game_name='" << game_name << "', version='" << version << "'" << std::endl;
+    LOG_DEBUG("llegint mapa - game_name='" << game_name << "', version='" << version << "'");
     
     // Llegir paràmetres del mapa
     while (std::getline(is, line) && !line.empty()) {
-        std::cerr << "Debug: llegint paràmetre del mapa: '" << line << "'" << std::endl;
+        LOG_DEBUG("llegint paràmetre del mapa: '" << line << "'");
         iss.clear();
         iss.str(line);
         std::string key, value;
@@ -51,50 +52,45 @@ bool Board::parseMapFile(std::istream& is) {
         
         if (key == "nb_players") {
             nb_players = std::stoi(value);
-            std::cerr << "Debug: nb_players = " << nb_players << std::endl;
+            LOG_DEBUG("nb_players = " << nb_players);
         }
         else if (key == "rows") {
             rows = std::stoi(value);
-            std::cerr << "Debug: rows = " << rows << std::endl;
+            LOG_DEBUG("rows = " << rows);
         }
         else if (key == "cols") {
             cols = std::stoi(value);
-            std::cerr << "Debug: cols = " << cols << std::endl;
+            LOG_DEBUG("cols = " << cols);
         }
         else if (key == "FIXED") {
             // Hem arribat al grid, saltar línia buida
-            std::cerr << "Debug: detectat grid FIXED" << std::endl;
+            LOG_DEBUG("detectat grid FIXED");
             std::getline(is, line); // Saltar línia buida després de FIXED
             break;
         }
     }
     
     // Llegir grid del mapa
-    std::cerr << "Debug: llegint grid " << rows << "x" << cols << std::endl;
-    grid.clear();
-    grid.resize(rows, std::vector<Cell>(cols));
+    LOG_DEBUG("llegint grid " << rows << "x" << cols);
+    resetGrid();
     
     for (int i = 0; i < rows; ++i) {
         if (!std::getline(is, line)) {
-            std::cerr << "Error: No s'ha pogut llegir la línia " << i << " del grid" << std::endl;
+            LOG_ERROR("No s'ha pogut llegir la línia " << i << " del grid");
             return false;
         }
         
-        std::cerr << "Debug: llegint línia " << i << " del grid: '" << line << "' (longitud: " << line.length() << ")" << std::endl;
+        LOG_DEBUG("llegint línia " << i << " del grid: '" << line << "' (longitud: " << line.length() << ")");
         
         if (static_cast<int>(line.length()) != cols) {
-            std::cerr << "Error: La línia " << i << " del grid té longitud incorrecta: " << line.length() << " (esperat: " << cols << ")" << std::endl;
+            LOG_ERROR("La línia " << i << " del grid té longitud incorrecta: " << line.length() << " (esperat: " << cols << ")");
             return false;
         }
         
         for (int j = 0; j < cols; ++j) {
+            // Qualsevol altre caràcter pot ser una unitat, ho tractarem després
             if (line[j] == 'X') {
-                grid[i][j] = Cell(Wall, i, j);
-            } else if (line[j] == '.') {
-                grid[i][j] = Cell(Empty, i, j);
-            } else {
-                // Això pot ser una unitat, ho tractarem després
-                grid[i][j] = Cell(Empty, i, j);
+                cell_type_[cellIndex(i, j)] = Wall;
             }
         }
     }
@@ -102,6 +98,21 @@ bool Board::parseMapFile(std::istream& is) {
     return true;
 }
 
+void Board::resetGrid() {
+    cell_type_.assign(rows * cols, Empty);
+    cell_owner_.assign(rows * cols, -1);
+    cell_unit_.assign(rows * cols, -1);
+}
+
+void Board::placeUnit(int unit_id, int x, int y) {
+    if (unit_id >= static_cast<int>(unit_cell_.size())) {
+        unit_cell_.resize(unit_id + 1, -1);
+    }
+    int cell = cellIndex(x, y);
+    cell_unit_[cell] = unit_id;
+    unit_cell_[unit_id] = cell;
+}
+
 bool Board::parseOriginalMap(std::istream& is) {
     std::string line;
     
@@ -113,11 +124,11 @@ bool Board::parseOriginalMap(std::istream& is) {
     iss >> game_name >> version;
     
     // Debug: imprimir el que hem llegit
-    std::cerr << "Debug: game_name='" << game_name << "', version='" << version << "'" << std::endl;
+    LOG_DEBUG("game_name='" << game_name << "', version='" << version << "'");
     
     // Llegir paràmetres del joc
     while (std::getline(is, line) && !isGameSection(line) && !line.empty()) {
-        std::cerr << "Debug: llegint paràmetre: '" << line << "'" << std::endl;
+        LOG_DEBUG("llegint paràmetre: '" << line << "'");
         iss.clear();
         iss.str(line);
         std::string key, value;
@@ -125,26 +136,26 @@ bool Board::parseOriginalMap(std::istream& is) {
         
         if (key == "nb_players") {
             nb_players = std::stoi(value);
-            std::cerr << "Debug: nb_players = " << nb_players << std::endl;
+            LOG_DEBUG("nb_players = " << nb_players);
         }
         else if (key == "nb_rounds") {
             // Ignorar, utilitzem el de game_def
         }
         else if (key == "rows") {
             rows = std::stoi(value);
-            std::cerr << "Debug: rows = " << rows << std::endl;
+            LOG_DEBUG("rows = " << rows);
         }
         else if (key == "cols") {
             cols = std::stoi(value);
-            std::cerr << "Debug: cols = " << cols << std::endl;
+            LOG_DEBUG("cols = " << cols);
         }
         else if (key == "names" || key == "round") {
             // Ignorar línies que no són paràmetres del joc
-            std::cerr << "Debug: ignorant línia: " << key << std::endl;
+            LOG_DEBUG("ignorant línia: " << key);
         }
         else if (key.length() == cols && key.find_first_not_of("X.") == std::string::npos) {
             // Aquesta línia sembla ser el grid! Tornar enrere
-            std::cerr << "Debug: detectat grid, tornant enrere" << std::endl;
+            LOG_DEBUG("detectat grid, tornant enrere");
             // Tornar la línia al stream
             is.seekg(-static_cast<int>(line.length() + 1), std::ios::cur);
             break;
@@ -155,38 +166,32 @@ bool Board::parseOriginalMap(std::istream& is) {
     if (rows == 0 || cols == 0) {
         rows = game_def->getDefaultRows();
         cols = game_def->getDefaultCols();
-        std::cerr << "Debug: utilitzant dimensions del game_def: " << rows << "x" << cols << std::endl;
+        LOG_DEBUG("utilitzant dimensions del game_def: " << rows << "x" << cols);
     }
     
     // Si no hem arribat al final del fitxer, saltar línies buides
     if (is.good()) {
         while (std::getline(is, line) && line.empty()) {
-            std::cerr << "Debug: saltant línia buida" << std::endl;
+            LOG_DEBUG("saltant línia buida");
         }
     }
     
     // Llegir grid del mapa
-    std::cerr << "Debug: llegint grid " << rows << "x" << cols << std::endl;
-    grid.clear();
-    grid.resize(rows, std::vector<Cell>(cols));
+    LOG_DEBUG("llegint grid " << rows << "x" << cols);
+    resetGrid();
     
     for (int i = 0; i < rows; ++i) {
         if (!std::getline(is, line)) {
-            std::cerr << "Debug: error llegint línia " << i << " del grid" << std::endl;
+            LOG_ERROR("llegint línia " << i << " del grid");
             return false;
         }
-        std::cerr << "Debug: línia " << i << ": '" << line << "'" << std::endl;
+        LOG_DEBUG("línia " << i << ": '" << line << "'");
         
         for (int j = 0; j < cols && j < static_cast<int>(line.length()); ++j) {
             char c = line[j];
+            // Capsule (C) i Ball (B) es tracten com Empty per ara
             if (c == 'X') {
-                grid[i][j] = Cell(Wall, i, j);
-            } else if (c == 'C') {
-                grid[i][j] = Cell(Empty, i, j); // Capsule - tractar com Empty per ara
-            } else if (c == 'B') {
-                grid[i][j] = Cell(Empty, i, j); // Ball - tractar com Empty per ara
-            } else {
-                grid[i][j] = Cell(Empty, i, j);
+                cell_type_[cellIndex(i, j)] = Wall;
             }
         }
     }
@@ -235,6 +240,8 @@ bool Board::initialize() {
 void Board::placeInitialUnits() {
     // Crear unitats inicials basades en la definició del joc
     int unit_id = 0;
+    int farmer_type = game_def->getUnitTypeId("Farmer");
+    int knight_type = game_def->getUnitTypeId("Knight");
     
     for (int player_id = 0; player_id < nb_players; ++player_id) {
         // Crear farmers
@@ -242,12 +249,10 @@ void Board::placeInitialUnits() {
             int x = 2 + (player_id % 2) * (rows - 4);
             int y = 2 + (player_id / 2) * (cols - 4) + i;
             
-            if (x < rows && y < cols && grid[x][y].type == Empty) {
-                Unit unit("Farmer", player_id, x, y, 100);
+            if (x < rows && y < cols && cell_type_[cellIndex(x, y)] == Empty) {
+                Unit unit(farmer_type, player_id, x, y, 100);
                 units.push_back(unit);
-                position_to_unit[{x, y}] = unit_id;
-                unit_to_position[unit_id] = {x, y};
-                grid[x][y].unit = unit_id;
+                placeUnit(unit_id, x, y);
                 unit_id++;
             }
         }
@@ -257,12 +262,10 @@ void Board::placeInitialUnits() {
             int x = 3 + (player_id % 2) * (rows - 6);
             int y = 3 + (player_id / 2) * (cols - 6) + i;
             
-            if (x < rows && y < cols && grid[x][y].type == Empty) {
-                Unit unit("Knight", player_id, x, y, 200);
+            if (x < rows && y < cols && cell_type_[cellIndex(x, y)] == Empty) {
+                Unit unit(knight_type, player_id, x, y, 200);
                 units.push_back(unit);
-                position_to_unit[{x, y}] = unit_id;
-                unit_to_position[unit_id] = {x, y};
-                grid[x][y].unit = unit_id;
+                placeUnit(unit_id, x, y);
                 unit_id++;
             }
         }
@@ -270,36 +273,64 @@ void Board::placeInitialUnits() {
 }
 
 std::shared_ptr<Board> Board::next(const std::vector<Action>& actions, Action& actions_done) {
-    // Crear una còpia del tauler actual
-    auto new_board = std::make_shared<Board>(game_def);
-    new_board->grid = grid;
-    new_board->units = units;
-    new_board->scores = scores;
-    new_board->player_names = player_names;
-    new_board->current_round = current_round + 1;
-    new_board->nb_players = nb_players;
-    new_board->rows = rows;
-    new_board->cols = cols;
-    new_board->position_to_unit = position_to_unit;
-    new_board->unit_to_position = unit_to_position;
-    
-    // Copiar camps del format Dominator
-    new_board->land_ = land_;
-    new_board->total_score_ = total_score_;
-    new_board->cpu_status_ = cpu_status_;
+    // Crear una còpia del tauler actual i avançar-la
+    auto new_board = std::make_shared<Board>(*this);
+    new_board->advance(actions, actions_done);
+    return new_board;
+}
+
+void Board::advance(const std::vector<Action>& actions, Action& actions_done) {
+    // Reiniciar el registre sense alliberar la memòria reservada
+    delta_.round = current_round;
+    delta_.units.clear();
+    delta_.scores = scores;
+    delta_.land = land_;
+    delta_.total_score = total_score_;
+    
+    ++current_round;
     
     // Aplicar totes les accions
     for (const auto& action : actions) {
-        new_board->applyAction(action);
+        applyAction(action);
     }
     
     // Actualitzar estat de les unitats
-    new_board->updateUnitStates();
+    updateUnitStates();
     
     // Recalcular puntuacions després dels moviments
-    new_board->computeScores();
+    computeScores();
+}
+
+bool Board::undo() {
+    if (delta_.round < 0) return false;
+    
+    // Restaurar les unitats en ordre invers al d'aplicació
+    for (auto it = delta_.units.rbegin(); it != delta_.units.rend(); ++it) {
+        Unit& unit = units[it->unit_id];
+        if (unit.x != it->x || unit.y != it->y) {
+            int cell = cellIndex(it->x, it->y);
+            cell_unit_[unit_cell_[it->unit_id]] = -1;
+            cell_unit_[cell] = it->unit_id;
+            unit_cell_[it->unit_id] = cell;
+            unit.x = it->x;
+            unit.y = it->y;
+        }
+        unit.health = it->health;
+    }
     
-    return new_board;
+    current_round = delta_.round;
+    scores.swap(delta_.scores);
+    land_.swap(delta_.land);
+    total_score_.swap(delta_.total_score);
+    
+    delta_.round = -1;
+    delta_.units.clear();
+    return true;
+}
+
+void Board::recordUnit(int unit_id) {
+    const Unit& unit = units[unit_id];
+    delta_.units.emplace_back(unit_id, unit.x, unit.y, unit.health);
 }
 
 void Board::printPreamble(std::ostream& os) const {
@@ -315,11 +346,12 @@ void Board::print(std::ostream& os) const {
     // Imprimir grid
     for (int i = 0; i < rows; ++i) {
         for (int j = 0; j < cols; ++j) {
-            if (grid[i][j].type == Wall) {
+            int cell = cellIndex(i, j);
+            if (cell_type_[cell] == Wall) {
                 os << 'X';
-            } else if (grid[i][j].unit != -1) {
+            } else if (cell_unit_[cell] != -1) {
                 // Imprimir número del jugador propietari
-                const Unit* unit = getUnit(grid[i][j].unit);
+                const Unit* unit = getUnit(cell_unit_[cell]);
                 if (unit) {
                     os << unit->player_id;
                 } else {
@@ -334,12 +366,12 @@ void Board::print(std::ostream& os) const {
     os << std::endl;
 }
 
-const Board::Cell& Board::getCell(int x, int y) const {
-    static Cell empty_cell;
-    if (x >= 0 && x < rows && y >= 0 && y < cols) {
-        return grid[x][y];
+Board::Cell Board::getCell(int x, int y) const {
+    if (isInside(x, y)) {
+        int cell = cellIndex(x, y);
+        return Cell(static_cast<CellType>(cell_type_[cell]), cell_owner_[cell], cell_unit_[cell]);
     }
-    return empty_cell;
+    return Cell();
 }
 
 const Board::Unit* Board::getUnit(int unit_id) const {
@@ -360,6 +392,13 @@ std::vector<Board::Unit> Board::getUnitsByPlayer(int player_id) const {
 }
 
 std::vector<Board::Unit> Board::getUnitsByType(const std::string& type) const {
+    // Un tipus que no és a la definició del joc no té unitats
+    int type_id = game_def->getUnitTypeId(type);
+    if (type_id < 0) return std::vector<Unit>();
+    return getUnitsByType(type_id);
+}
+
+std::vector<Board::Unit> Board::getUnitsByType(int type) const {
     std::vector<Unit> result;
     for (const auto& unit : units) {
         if (unit.type == type) {
@@ -415,18 +454,17 @@ bool Board::moveUnit(int unit_id, int direction) {
     }
     
     // Verificar si la nova posició és vàlida
-    if (new_x < 0 || new_x >= rows || new_y < 0 || new_y >= cols) return false;
-    if (grid[new_x][new_y].type == Wall) return false;
-    if (grid[new_x][new_y].unit != -1) return false; // Ja hi ha una unitat
+    if (!isInside(new_x, new_y)) return false;
+    int cell = cellIndex(new_x, new_y);
+    if (cell_type_[cell] == Wall) return false;
+    if (cell_unit_[cell] != -1) return false; // Ja hi ha una unitat
     
-    // Moure la unitat
-    grid[unit->x][unit->y].unit = -1;
-    grid[new_x][new_y].unit = unit_id;
+    recordUnit(unit_id);
     
-    // Actualitzar posicions
-    position_to_unit.erase({unit->x, unit->y});
-    position_to_unit[{new_x, new_y}] = unit_id;
-    unit_to_position[unit_id] = {new_x, new_y};
+    // Moure la unitat
+    cell_unit_[unit_cell_[unit_id]] = -1;
+    cell_unit_[cell] = unit_id;
+    unit_cell_[unit_id] = cell;
     
     // Actualitzar unitat
     units[unit_id].x = new_x;
@@ -447,9 +485,11 @@ bool Board::captureCell(int unit_id, int x, int y) {
 
 void Board::updateUnitStates() {
     // Actualitzar vida de les unitats, etc.
-    for (auto& unit : units) {
+    for (int id = 0; id < static_cast<int>(units.size()); ++id) {
+        Unit& unit = units[id];
         // Regeneració de vida
         if (unit.health < unit.max_health) {
+            recordUnit(id);
             unit.health = std::min(unit.max_health, unit.health + 10);
         }
     }
@@ -507,97 +547,94 @@ void Board::parseUnitLine(const std::string& line) {
         int strength = (values.size() > 4) ? std::stoi(values[4]) : 100;
         
         // Crear unitat
-        Unit unit(unit_type, player, x, y, strength);
+        Unit unit(game_def->getUnitTypeId(unit_type), player, x, y, strength);
         units.push_back(unit);
         
         // Actualitzar cel·la
-        if (x >= 0 && x < rows && y >= 0 && y < cols) {
-            grid[x][y].unit = units.size() - 1;
-            grid[x][y].owner = player;
+        int unit_id = units.size() - 1;
+        unit_cell_.push_back(-1);
+        if (isInside(x, y)) {
+            placeUnit(unit_id, x, y);
+            cell_owner_[cellIndex(x, y)] = player;
         }
     }
 }
 
 void Board::printUnits(std::ostream& os) const {
     // Imprimir totes les unitats en format Dominator
+    Writer w;
     for (const auto& unit : units) {
-        // Format: tipus player_id x y health
-        char type_char = 'f'; // Default farmer
-        if (unit.type == "knight") type_char = 'k';
-        else if (unit.type == "witch") type_char = 'w';
-        else if (unit.type == "farmer") type_char = 'f';
-        
-        os << type_char << " " << unit.player_id << " " << unit.x << " " << unit.y << " " << unit.health << std::endl;
+        printUnit(w, unit);
     }
+    w.writeTo(os);
+}
+
+void Board::printUnit(Writer& os, const Unit& unit) const {
+    // Format: tipus player_id x y health
+    os << unitTypeChar(unit.type) << " " << unit.player_id << " " << unit.x << " " << unit.y << " " << unit.health << '\n';
 }
 
-void Board::printRoundState(std::ostream& os) const {
-    os << std::endl << std::endl;
+void Board::printRoundState(Writer& os) const {
+    os << "\n\n";
     
     // Imprimir grid
     for (int i = 0; i < rows; ++i) {
         for (int j = 0; j < cols; ++j) {
-            if (grid[i][j].type == Wall) {
+            int cell = cellIndex(i, j);
+            int owner = cell_owner_[cell];
+            if (cell_type_[cell] == Wall) {
                 os << 'X';
-            } else if (grid[i][j].owner == -1) {
+            } else if (owner == -1) {
                 os << '.';
-            } else if (grid[i][j].owner >= 0 && grid[i][j].owner < nb_players) {
-                os << grid[i][j].owner;
+            } else if (owner >= 0 && owner < nb_players) {
+                os << owner;
             } else {
                 os << '.';
             }
         }
-        os << std::endl;
+        os << '\n';
     }
     
-    os << std::endl;
+    os << '\n';
     
     // Només imprimir informació de la ronda si no és la ronda 0
     if (current_round > 0) {
-        os << "round " << current_round << std::endl;
+        os << "round " << current_round << '\n';
         
         os << "land";
         for (int i = 0; i < nb_players; ++i) {
             os << " " << land_[i];
         }
-        os << std::endl;
+        os << '\n';
         
         os << "total_score";
         for (int i = 0; i < nb_players; ++i) {
             os << " " << total_score_[i];
         }
-        os << std::endl;
+        os << '\n';
         
         os << "status";
         for (int i = 0; i < nb_players; ++i) {
             os << " " << cpu_status_[i];
         }
-        os << std::endl;
+        os << '\n';
     }
     
     // Imprimir unitats
     for (const auto& unit : units) {
-        char type_char = 'f';
-        if (unit.type == "knight") type_char = 'k';
-        else if (unit.type == "witch") type_char = 'w';
-        else if (unit.type == "farmer") type_char = 'f';
-        
-        os << type_char << " " << unit.player_id << " " << unit.x << " " << unit.y << " " << unit.health << std::endl;
+        printUnit(os, unit);
     }
-    os << std::endl;
+    os << '\n';
 }
 
 void Board::computeScores() {
-    // Inicialitzar land_ amb zeros
-    land_ = std::vector<int>(nb_players, 0);
+    // Inicialitzar land_ amb zeros (reaprofitant la memòria)
+    land_.assign(nb_players, 0);
     
-    // Comptar terreny controlat per cada jugador
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            int owner = grid[i][j].owner;
-            if (owner >= 0 && owner < nb_players) {
-                ++land_[owner];
-            }
+    // Comptar terreny controlat per cada jugador (recorregut lineal de la graella)
+    for (int owner : cell_owner_) {
+        if (owner >= 0 && owner < nb_players) {
+            ++land_[owner];
         }
     }
     
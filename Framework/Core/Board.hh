@@ -3,9 +3,9 @@
 
 #include "GameDefinition.hh"
 #include "Action.hh"
+#include "Writer.hh"
 #include <string>
 #include <vector>
-#include <map>
 #include <memory>
 #include <istream>
 #include <ostream>
@@ -24,36 +24,58 @@ public:
     };
     
     /**
-     * Representa una cel·la del tauler
+     * Vista d'una cel·la del tauler (la graella es desa per camps, vegeu cell_type_)
      */
     struct Cell {
         CellType type;
         int owner;      // Propietari de la cel·la (-1 si cap)
         int unit;       // ID de la unitat en aquesta cel·la (-1 si cap)
-        int x, y;       // Posició
         
-        Cell() : type(Empty), owner(-1), unit(-1), x(0), y(0) {}
-        Cell(CellType t, int x_pos, int y_pos) : type(t), owner(-1), unit(-1), x(x_pos), y(y_pos) {}
+        Cell() : type(Empty), owner(-1), unit(-1) {}
+        Cell(CellType t, int o, int u) : type(t), owner(o), unit(u) {}
     };
     
     /**
      * Representa una unitat al tauler
      */
     struct Unit {
-        std::string type;       // Tipus d'unitat (Farmer, Knight, etc.)
+        int type;               // Id del tipus d'unitat a GameDefinition (-1 si desconegut)
         int player_id;          // ID del jugador propietari
         int x, y;               // Posició
         int health;             // Vida actual
         int max_health;         // Vida màxima
         
-        Unit() : player_id(-1), x(0), y(0), health(100), max_health(100) {}
-        Unit(const std::string& t, int player, int x_pos, int y_pos, int h = 100) 
+        Unit() : type(-1), player_id(-1), x(0), y(0), health(100), max_health(100) {}
+        Unit(int t, int player, int x_pos, int y_pos, int h = 100) 
             : type(t), player_id(player), x(x_pos), y(y_pos), health(h), max_health(h) {}
     };
+    
+    /**
+     * Estat previ d'una unitat modificada durant una ronda
+     */
+    struct UnitChange {
+        int unit_id;
+        int x, y;
+        int health;
+        
+        UnitChange(int id, int x_pos, int y_pos, int h) : unit_id(id), x(x_pos), y(y_pos), health(h) {}
+    };
+    
+    /**
+     * Registre de canvis d'una ronda aplicada in situ, suficient per desfer-la
+     */
+    struct Delta {
+        int round;                          // Ronda abans d'avançar
+        std::vector<UnitChange> units;      // Unitats modificades, en ordre d'aplicació
+        std::vector<int> scores;            // Puntuacions abans d'avançar
+        std::vector<int> land;              // Terreny abans d'avançar
+        std::vector<int> total_score;       // Puntuació total abans d'avançar
+        
+        Delta() : round(-1) {}
+    };
 
 private:
     std::shared_ptr<GameDefinition> game_def;
-    std::vector<std::vector<Cell>> grid;
     std::vector<Unit> units;
     std::vector<int> scores;
     std::vector<std::string> player_names;
@@ -66,9 +88,16 @@ private:
     std::vector<int> total_score_;   // Puntuació total de cada jugador
     std::vector<double> cpu_status_; // Estat de CPU de cada jugador
     
-    // Mapeig de posicions a unitats
-    std::map<std::pair<int, int>, int> position_to_unit;
-    std::map<int, std::pair<int, int>> unit_to_position;
+    // Graella contigua en ordre de files (índex x * cols + y), un vector per camp
+    std::vector<unsigned char> cell_type_;  // CellType de cada cel·la
+    std::vector<int> cell_owner_;           // Propietari de cada cel·la (-1 si cap)
+    std::vector<int> cell_unit_;            // Unitat de cada cel·la (-1 si cap)
+    
+    // Índex de cel·la de cada unitat, indexat per ID (-1 si és fora del tauler)
+    std::vector<int> unit_cell_;
+    
+    // Registre de l'última ronda aplicada amb advance()
+    Delta delta_;
 
 public:
     Board(std::shared_ptr<GameDefinition> def);
@@ -89,6 +118,22 @@ public:
      */
     std::shared_ptr<Board> next(const std::vector<Action>& actions, Action& actions_done);
     
+    /**
+     * Aplica les accions sobre aquest mateix tauler, sense fer-ne cap còpia,
+     * i en desa els canvis a un registre que permet desfer la ronda
+     */
+    void advance(const std::vector<Action>& actions, Action& actions_done);
+    
+    /**
+     * Desfà l'última ronda aplicada amb advance(). Retorna fals si no n'hi ha cap
+     */
+    bool undo();
+    
+    /**
+     * Obté el registre de canvis de l'última ronda aplicada
+     */
+    inline const Delta& getLastDelta() const { return delta_; }
+    
     /**
      * Imprimeix el preàmbul del joc
      */
@@ -110,7 +155,17 @@ public:
     /**
      * Obté una cel·la específica
      */
-    const Cell& getCell(int x, int y) const;
+    Cell getCell(int x, int y) const;
+    
+    /**
+     * Verifica si una posició és dins del tauler
+     */
+    inline bool isInside(int x, int y) const { return x >= 0 && x < rows && y >= 0 && y < cols; }
+    
+    /**
+     * Obté la unitat d'una posició vàlida (-1 si cap)
+     */
+    inline int getUnitAt(int x, int y) const { return cell_unit_[cellIndex(x, y)]; }
     
     /**
      * Obté una unitat per ID
@@ -127,6 +182,11 @@ public:
      */
     std::vector<Unit> getUnitsByType(const std::string& type) const;
     
+    /**
+     * Obté les unitats d'un tipus específic, donat el seu id
+     */
+    std::vector<Unit> getUnitsByType(int type) const;
+    
     /**
      * Obté la puntuació d'un jugador
      */
@@ -143,9 +203,9 @@ public:
     void printUnits(std::ostream& os) const;
     
     /**
-     * Imprimeix l'estat de la ronda (format Dominator)
+     * Imprimeix l'estat de la ronda (format Dominator) al buffer de sortida
      */
-    void printRoundState(std::ostream& os) const;
+    void printRoundState(Writer& os) const;
     
     /**
      * Calcula les puntuacions de terreny
@@ -153,6 +213,21 @@ public:
     void computeScores();
 
 protected:
+    /**
+     * Índex lineal d'una posició dins la graella
+     */
+    inline int cellIndex(int x, int y) const { return x * cols + y; }
+    
+    /**
+     * Redimensiona la graella a rows x cols cel·les buides
+     */
+    void resetGrid();
+    
+    /**
+     * Col·loca una unitat nova en una cel·la i n'actualitza els índexs
+     */
+    void placeUnit(int unit_id, int x, int y);
+    
     /**
      * Carrega el mapa des d'un stream
      */
@@ -173,6 +248,23 @@ protected:
      */
     void placeInitialUnits();
     
+    /**
+     * Caràcter amb què s'imprimeix un tipus d'unitat ('f' si és desconegut)
+     */
+    inline char unitTypeChar(int type) const {
+        return type >= 0 ? game_def->getUnitType(type).symbol_char : 'f';
+    }
+    
+    /**
+     * Imprimeix una línia d'unitat (format Dominator)
+     */
+    void printUnit(Writer& os, const Unit& unit) const;
+    
+    /**
+     * Desa l'estat actual d'una unitat al registre de la ronda
+     */
+    void recordUnit(int unit_id);
+    
     /**
      * Actualitza l'estat de les unitats
      */
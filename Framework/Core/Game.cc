@@ -1,4 +1,5 @@
 #include "Game.hh"
+#include "Log.hh"
 #include <iostream>
 
 Game::Game(std::shared_ptr<GameDefinition> def) 
@@ -11,13 +12,13 @@ bool Game::loadMap(const std::string& map_file) {
     
     // Carregar el mapa
     if (!board->loadFromFile(map_file)) {
-        std::cerr << "Error carregant el mapa: " << map_file << std::endl;
+        LOG_ERROR("carregant el mapa: " << map_file);
         return false;
     }
     
     // Inicialitzar el tauler
     if (!board->initialize()) {
-        std::cerr << "Error inicialitzant el tauler" << std::endl;
+        LOG_ERROR("inicialitzant el tauler");
         return false;
     }
     
@@ -30,12 +31,12 @@ void Game::addPlayer(std::shared_ptr<Player> player) {
 
 void Game::run(std::ostream& os) {
     if (!board) {
-        std::cerr << "Error: No s'ha carregat cap mapa" << std::endl;
+        LOG_ERROR("No s'ha carregat cap mapa");
         return;
     }
     
     if (static_cast<int>(players.size()) != game_def->getMaxPlayers()) {
-        std::cerr << "Error: Nombre de jugadors incorrecte" << std::endl;
+        LOG_ERROR("Nombre de jugadors incorrecte");
         return;
     }
     
@@ -71,22 +72,24 @@ void Game::run(std::ostream& os) {
     os << std::endl;
     
     // Imprimir estat inicial (format Dominator)
-    board->printRoundState(os);
+    board->printRoundState(writer);
+    writer.writeTo(os);
     
     // Executar totes les rondes (començant per la ronda 1)
     for (current_round = 1; current_round <= game_def->getDefaultRounds(); ++current_round) {
-        std::cerr << "Iniciant ronda " << current_round << std::endl;
+        LOG_INFO("Iniciant ronda " << current_round);
         playRound(os);
     }
     
-    std::cerr << "Partida completada" << std::endl;
+    LOG_INFO("Partida completada");
 }
 
 void Game::playRound(std::ostream& os) {
     // Recollir accions de tots els jugadors
     std::vector<Action> actions;
     for (int player_id = 0; player_id < static_cast<int>(players.size()); ++player_id) {
-        std::cerr << "Processant jugador " << player_id << std::endl;
+        LOG_INFO("Processant jugador " << player_id);
+        Log::flush(); // el jugador també pot escriure a std::cerr
         
         // Crear acció buida
         Action action;
@@ -101,17 +104,15 @@ void Game::playRound(std::ostream& os) {
         actions.push_back(action);
     }
     
-    // Aplicar totes les accions al tauler
+    // Aplicar totes les accions directament sobre el tauler (sense còpia)
     Action actions_done;
-    std::shared_ptr<Board> new_board = board->next(actions, actions_done);
+    board->advance(actions, actions_done);
     
     // Imprimir moviments realitzats (format Dominator)
-    os << "movements" << std::endl;
-    actions_done.print(os);
+    writer << "movements" << '\n';
+    actions_done.print(writer);
     
-    // Imprimir estat de la ronda (format Dominator)
-    new_board->printRoundState(os);
-    
-    // Actualitzar tauler
-    board = new_board;
+    // Imprimir estat de la ronda (format Dominator) i escriure-ho tot d'un sol cop
+    board->printRoundState(writer);
+    writer.writeTo(os);
 }
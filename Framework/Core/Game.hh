@@ -21,6 +21,7 @@ private:
     std::shared_ptr<Board> board;
     std::vector<std::shared_ptr<Player>> players;
     int current_round;
+    Writer writer;  // Buffer on es formata cada ronda abans d'escriure-la
     
 public:
     Game(std::shared_ptr<GameDefinition> def);
@@ -1,13 +1,14 @@
 #include "GameDefinition.hh"
 #include <fstream>
 #include <sstream>
+#include "Log.hh"
 #include <iostream>
 #include <algorithm>
 
 bool GameDefinition::loadFromFile(const std::string& filename) {
     std::ifstream file(filename);
     if (!file.is_open()) {
-        std::cerr << "Error: No s'ha pogut obrir el fitxer " << filename << std::endl;
+        LOG_ERROR("No s'ha pogut obrir el fitxer " << filename);
         return false;
     }
     
@@ -33,7 +34,7 @@ bool GameDefinition::loadFromStream(std::istream& is) {
         // Detectar seccions
         if (line[0] == '[' && line[line.length()-1] == ']') {
             current_section = line.substr(1, line.length()-2);
-            std::cerr << "Debug: secció detectada: '" << current_section << "'" << std::endl;
+            LOG_DEBUG("secció detectada: '" << current_section << "'");
             continue;
         }
         
@@ -58,31 +59,31 @@ bool GameDefinition::loadFromStream(std::istream& is) {
             // Guardar la línia per parsejar-la després
             std::istringstream iss(line);
             if (!parseUnitType(iss)) {
-                std::cerr << "Error parsejant tipus d'unitat: " << line << std::endl;
+                LOG_ERROR("parsejant tipus d'unitat: " << line);
                 return false;
             }
         } else if (current_section == "RULES") {
             std::istringstream iss(line);
             if (!parseGameRule(iss)) {
-                std::cerr << "Error parsejant regla: " << line << std::endl;
+                LOG_ERROR("parsejant regla: " << line);
                 return false;
             }
         } else if (current_section == "MECHANICS") {
             std::istringstream iss(line);
             if (!parseGameMechanic(iss)) {
-                std::cerr << "Error parsejant mecànica: " << line << std::endl;
+                LOG_ERROR("parsejant mecànica: " << line);
                 return false;
             }
         } else if (current_section == "ACTION_TYPES") {
             std::istringstream iss(line);
             if (!parseActionType(iss)) {
-                std::cerr << "Error parsejant tipus d'acció: " << line << std::endl;
+                LOG_ERROR("parsejant tipus d'acció: " << line);
                 return false;
             }
         } else if (current_section == "ACTION_STRUCTURE") {
             std::istringstream iss(line);
             if (!parseActionStructure(iss)) {
-                std::cerr << "Error parsejant estructura d'acció: " << line << std::endl;
+                LOG_ERROR("parsejant estructura d'acció: " << line);
                 return false;
             }
         }         else if (current_section == "CONSTANTS") {
@@ -101,17 +102,17 @@ bool GameDefinition::loadFromStream(std::istream& is) {
         }
         else if (current_section == "MAP_SECTIONS") {
             if (!parseMapSections(line)) {
-                std::cerr << "Error parsejant seccions del mapa: " << line << std::endl;
+                LOG_ERROR("parsejant seccions del mapa: " << line);
             }
         }
         else if (current_section == "MAP_OBJECTS") {
             if (!parseMapObjects(line)) {
-                std::cerr << "Error parsejant objectes del mapa: " << line << std::endl;
+                LOG_ERROR("parsejant objectes del mapa: " << line);
             }
         }
         else if (current_section == "UNIT_PARSING") {
             if (!parseUnitParsing(line)) {
-                std::cerr << "Error parsejant format d'unitats: " << line << std::endl;
+                LOG_ERROR("parsejant format d'unitats: " << line);
             }
         }
         // Ignorar seccions desconegudes (AI_FUNCTIONS, AI_ACTIONS, AI_UTILITIES, FUNCTION_MAPPINGS)
@@ -144,6 +145,23 @@ bool GameDefinition::parseUnitType(std::istream& is) {
         unit_type.abilities.push_back(ability);
     }
     
+    // Lletra amb què s'imprimeix, la mateixa que abans dels ids:
+    // "knight" i "witch" tenen la seva, i tota la resta s'imprimeix com a 'f'
+    if (unit_type.name == "knight") unit_type.symbol_char = 'k';
+    else if (unit_type.name == "witch") unit_type.symbol_char = 'w';
+    else unit_type.symbol_char = 'f';
+
+    // Assignar un id compacte (una redefinició conserva l'id original)
+    auto it = unit_type_ids.find(unit_type.name);
+    if (it == unit_type_ids.end()) {
+        unit_type.id = unit_type_table.size();
+        unit_type_ids[unit_type.name] = unit_type.id;
+        unit_type_table.push_back(unit_type);
+    } else {
+        unit_type.id = it->second;
+        unit_type_table[unit_type.id] = unit_type;
+    }
+    
     unit_types[unit_type.name] = unit_type;
     return true;
 }
@@ -293,27 +311,27 @@ bool GameDefinition::parseGameConstant(const std::string& key, const std::string
 
 bool GameDefinition::validateConfiguration() const {
     if (game_name.empty()) {
-        std::cerr << "Error: Nom del joc no definit" << std::endl;
+        LOG_ERROR("Nom del joc no definit");
         return false;
     }
     
     if (max_players < 1) {
-        std::cerr << "Error: Nombre de jugadors invàlid: " << max_players << std::endl;
+        LOG_ERROR("Nombre de jugadors invàlid: " << max_players);
         return false;
     }
     
     if (default_rounds < 1) {
-        std::cerr << "Error: Nombre de rondes invàlid: " << default_rounds << std::endl;
+        LOG_ERROR("Nombre de rondes invàlid: " << default_rounds);
         return false;
     }
     
     if (default_rows < 1 || default_cols < 1) {
-        std::cerr << "Error: Dimensions del tauler invàlides: " << default_rows << "x" << default_cols << std::endl;
+        LOG_ERROR("Dimensions del tauler invàlides: " << default_rows << "x" << default_cols);
         return false;
     }
     
     if (unit_types.empty()) {
-        std::cerr << "Error: No hi ha tipus d'unitats definits" << std::endl;
+        LOG_ERROR("No hi ha tipus d'unitats definits");
         return false;
     }
     
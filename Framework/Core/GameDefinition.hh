@@ -18,8 +18,10 @@ public:
      * Estructura per definir un tipus d'unitat
      */
     struct UnitType {
+        int id;                     // Identificador compacte assignat en carregar
         std::string name;           // Nom del tipus d'unitat
         std::string symbol;         // Símbol per representar-lo
+        char symbol_char;           // Caràcter amb què s'imprimeix (calculat del nom)
         int max_health;             // Vida màxima
         int initial_health;         // Vida inicial
         int regen_rate;             // Taxa de regeneració per ronda
@@ -32,7 +34,7 @@ public:
         bool can_attack;            // Pot atacar?
         std::vector<std::string> abilities; // Habilitats especials
         
-        UnitType() : max_health(100), initial_health(100), regen_rate(0),
+        UnitType() : id(-1), symbol_char('?'), max_health(100), initial_health(100), regen_rate(0),
                     movement_range(1), attack_range(1), attack_power(0),
                     defense(0), can_capture(false), can_move(true), can_attack(false) {}
     };
@@ -84,6 +86,8 @@ protected:
     int default_cols;               // Columnes per defecte
     
     std::map<std::string, UnitType> unit_types;     // Tipus d'unitats disponibles
+    std::vector<UnitType> unit_type_table;          // Tipus d'unitats indexats per id
+    std::map<std::string, int> unit_type_ids;       // Nom del tipus -> id
     std::vector<GameRule> game_rules;               // Regles del joc
     std::vector<GameMechanic> game_mechanics;       // Mecàniques del joc
     std::map<int, ActionType> action_types;         // Tipus d'accions disponibles
@@ -119,6 +123,14 @@ public:
         return (it != unit_types.end()) ? &it->second : nullptr;
     }
     
+    // Mètodes per gestionar tipus d'unitats per id (sense comparar cadenes)
+    inline int getNbUnitTypes() const { return unit_type_table.size(); }
+    inline const UnitType& getUnitType(int id) const { return unit_type_table[id]; }
+    inline int getUnitTypeId(const std::string& name) const {
+        auto it = unit_type_ids.find(name);
+        return (it != unit_type_ids.end()) ? it->second : -1;
+    }
+    
     // Mètodes per gestionar regles i mecàniques
     inline const std::vector<GameRule>& getGameRules() const { return game_rules; }
     inline const std::vector<GameMechanic>& getGameMechanics() const { return game_mechanics; }
@@ -0,0 +1,122 @@
+#ifndef Log_hh
+#define Log_hh
+
+#include <cstdio>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+/**
+ * Nivell mínim de registre compilat (0 Debug, 1 Info, 2 Warning, 3 Error, 4 None).
+ * Els missatges per sota d'aquest nivell s'eliminen en temps de compilació.
+ */
+#ifndef LOG_LEVEL
+#define LOG_LEVEL 1
+#endif
+
+/**
+ * Registre per nivells cap a std::cerr a través d'un buffer per fil.
+ * El buffer s'escriu d'un sol cop quan s'omple, quan es registra un error,
+ * amb Log::flush() i quan el fil acaba.
+ */
+class Log {
+public:
+    /**
+     * Nivells de registre
+     */
+    enum Level {
+        Debug, Info, Warning, Error, None
+    };
+
+private:
+    static const size_t CAPACITY = 1 << 16;
+
+    /**
+     * Buffer de stream que acumula el text en una cadena
+     */
+    class Buffer : public std::streambuf {
+    public:
+        std::string data;
+    protected:
+        int_type overflow(int_type c) override {
+            if (c != traits_type::eof()) data.push_back(static_cast<char>(c));
+            return c;
+        }
+        std::streamsize xsputn(const char* s, std::streamsize n) override {
+            data.append(s, n);
+            return n;
+        }
+    };
+
+    /**
+     * Destinació dels missatges d'un fil
+     */
+    struct Sink {
+        Buffer buffer;
+        std::ostream os;
+
+        Sink() : os(&buffer) { buffer.data.reserve(CAPACITY); }
+        ~Sink() { flush(); }
+
+        void flush() {
+            if (buffer.data.empty()) return;
+            std::fwrite(buffer.data.data(), 1, buffer.data.size(), stderr);
+            std::fflush(stderr);
+            buffer.data.clear();
+        }
+    };
+
+    static Sink& sink() {
+        thread_local Sink s;
+        return s;
+    }
+
+    static int& minLevel() {
+        static int level = Debug;
+        return level;
+    }
+
+public:
+    /**
+     * Fixa el nivell mínim en temps d'execució (abans de començar cap partida)
+     */
+    static void setLevel(Level level) { minLevel() = level; }
+
+    /**
+     * Indica si els missatges d'un nivell s'escriuen
+     */
+    static bool isEnabled(Level level) { return level >= LOG_LEVEL && level >= minLevel(); }
+
+    /**
+     * Obté el stream on es formata el missatge actual
+     */
+    static std::ostream& stream() { return sink().os; }
+
+    /**
+     * Tanca el missatge actual
+     */
+    static void end(Level level) {
+        Sink& s = sink();
+        s.buffer.data.push_back('\n');
+        if (level >= Error || s.buffer.data.size() >= CAPACITY) s.flush();
+    }
+
+    /**
+     * Escriu els missatges pendents d'aquest fil
+     */
+    static void flush() { sink().flush(); }
+};
+
+/**
+ * Registra un missatge. Si el nivell és per sota de LOG_LEVEL la condició
+ * és constant i el compilador elimina tota la instrucció.
+ */
+#define LOG_MESSAGE(level, prefix, msg) \
+    do { if (Log::isEnabled(level)) { Log::stream() << prefix << msg; Log::end(level); } } while (0)
+
+#define LOG_DEBUG(msg)   LOG_MESSAGE(Log::Debug,   "Debug: ",   msg)
+#define LOG_INFO(msg)    LOG_MESSAGE(Log::Info,    "Info: ",    msg)
+#define LOG_WARNING(msg) LOG_MESSAGE(Log::Warning, "warning: ", msg)
+#define LOG_ERROR(msg)   LOG_MESSAGE(Log::Error,   "Error: ",   msg)
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef Writer_hh
+#define Writer_hh
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+
+/**
+ * Stream de sortida que acumula el text en un buffer reutilitzable
+ * fins que writeTo() l'escriu a la sortida real d'un sol cop.
+ * std::endl només acaba la línia: no buida res.
+ *
+ * Els enters, caràcters i cadenes s'afegeixen directament al buffer,
+ * sense locale ni sentinelles. La resta passa pel format habitual d'ostream.
+ */
+class Writer : public std::ostream {
+private:
+    static const size_t CAPACITY = 1 << 16;
+
+    /**
+     * Buffer de stream que acumula el text en una cadena
+     */
+    class Buffer : public std::streambuf {
+    public:
+        std::string data;
+    protected:
+        int_type overflow(int_type c) override {
+            if (c != traits_type::eof()) data.push_back(static_cast<char>(c));
+            return c;
+        }
+        std::streamsize xsputn(const char* s, std::streamsize n) override {
+            data.append(s, n);
+            return n;
+        }
+        int sync() override { return 0; }
+    };
+
+    Buffer buffer;
+
+public:
+    Writer() : std::ostream(&buffer) { buffer.data.reserve(CAPACITY); }
+
+    /**
+     * Afegeix un caràcter
+     */
+    void putChar(char c) { buffer.data.push_back(c); }
+
+    /**
+     * Afegeix una cadena
+     */
+    void putString(const char* s) { buffer.data.append(s); }
+    void putString(const std::string& s) { buffer.data.append(s); }
+
+    /**
+     * Afegeix un enter en decimal
+     */
+    void putInt(long long x) {
+        char digits[24];
+        int n = 0;
+        unsigned long long u = x < 0 ? -static_cast<unsigned long long>(x) : x;
+        do {
+            digits[n++] = static_cast<char>('0' + u % 10);
+            u /= 10;
+        } while (u != 0);
+        if (x < 0) buffer.data.push_back('-');
+        while (n > 0) buffer.data.push_back(digits[--n]);
+    }
+
+    /**
+     * Escriu el text acumulat a os i buida el buffer (en conserva la memòria)
+     */
+    void writeTo(std::ostream& os) {
+        os.write(buffer.data.data(), buffer.data.size());
+        buffer.data.clear();
+    }
+};
+
+inline Writer& operator<<(Writer& w, char c) {
+    w.putChar(c);
+    return w;
+}
+
+inline Writer& operator<<(Writer& w, const char* s) {
+    w.putString(s);
+    return w;
+}
+
+inline Writer& operator<<(Writer& w, const std::string& s) {
+    w.putString(s);
+    return w;
+}
+
+/**
+ * Enters de qualsevol mida (però no caràcters ni booleans)
+ */
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && sizeof(T) != 1, Writer&>::type
+operator<<(Writer& w, T x) {
+    w.putInt(x);
+    return w;
+}
+
+/**
+ * Booleans i reals conserven el format d'ostream (boolalpha, precisió...).
+ * Són plantilles perquè res més (com els manipuladors) s'hi converteixi.
+ */
+template <typename T>
+inline typename std::enable_if<std::is_same<T, bool>::value || std::is_floating_point<T>::value, Writer&>::type
+operator<<(Writer& w, T x) {
+    static_cast<std::ostream&>(w) << x;
+    return w;
+}
+
+#endif
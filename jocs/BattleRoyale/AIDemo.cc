@@ -46,12 +46,12 @@ struct PLAYER_NAME : public Player {
 
         const vector<int> f = farmers(me());
         for (int i = 0; i < sze(f); ++i) {
-            command(f[i], Dir(1 + random() % 4));
+            command(f[i], Dir(1 + randomize() % 4));
         }
         
         const vector<int>& k = knights(me());
         for (int i = 0; i < sze(k); ++i) {
-            command(k[i], Dir(1 + random() % 4));
+            command(k[i], Dir(1 + randomize() % 4));
         }
         
     }
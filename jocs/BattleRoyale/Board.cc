@@ -9,9 +9,11 @@
 
 using namespace std;
 
-Board::Board (istream& is, bool secgame) {
+Board::Board (istream& is, bool secgame, int seed) {
     string s, v;
 
+    srandomize(seed);
+
     //Version, compared part by part
     istringstream vs(version());
     while (!vs.eof()) {
@@ -81,7 +83,7 @@ Board::Board (istream& is, bool secgame) {
     }
 
     is >> s >> round_;
-    if (s == "?") cerr << "ERROR: Number of names does not match number of players" << endl;
+    if (s == "?") _log_error("Number of names does not match number of players");
     assert(s == "round");
     assert(round_ < nb_rounds_);
 
@@ -115,13 +117,22 @@ Board::Board (istream& is, bool secgame) {
                     cells_[i][j].type = Wall;
                     break;
                 default:
-                    cerr << "Unexpected '" << c << "' in board definition" << endl;
+                    _log_warning("Unexpected '" << c << "' in board definition");
                     assert(false);
             } 
         }
         //cerr << endl;
     }
     
+    owned_ = vector<int>(nb_players_, 0);
+    for (int i = 0; i < rows_; ++i) {
+        for (int j = 0; j < cols_; ++j) {
+            int o = cells_[i][j].owner;
+            assert(o < nb_players_);
+            if (o >= 0) owned_[o]++;
+        }
+    }
+
     is >> s;
     assert(s == "score");
     score_ = vector<int>(nb_players_);
@@ -201,7 +212,7 @@ Board::Board (istream& is, bool secgame) {
         }
     }
     else if (id < units_.size()) { //Half-full board given, error
-        cerr << "Read " << id << " units, expected " << units_.size() << endl;
+        _log_warning("Read " << id << " units, expected " << units_.size());
         assert(false);
     }
     else { //Full board given, ok
@@ -251,19 +262,19 @@ void Board::spawn_unit(int id) {
     
     int i, j;
     do {
-        i = mini + random() % (maxi-mini);
-        j = minj + random() % (maxj-minj);
+        i = mini + randomize() % (maxi-mini);
+        j = minj + randomize() % (maxj-minj);
     } while(cells_[i][j].type != Empty || cells_[i][j].unit != -1);
 
-    if (pos_ok(u.pos.i,u.pos.j)) cells_[u.pos.i][u.pos.j].unit = -1;
+    if (pos_ok(u.pos.i,u.pos.j)) cell_priv(u.pos).unit = -1;
     
-    cells_[i][j].unit = id;
+    cell_priv(Pos(i, j)).unit = id;
     
     u.pos.i = i;
     u.pos.j = j;
     
     if (u.type == Farmer) {
-        cells_[i][j].owner = u.player;
+        set_owner(u.pos, u.player);
     }
     
 }
@@ -291,16 +302,14 @@ void Board::update_vectors_by_player() {
 }
 
 void Board::update_scores() {
-    //Update scores
-    for (int player = 0; player < nb_players(); ++player) {
-        score_[player] = 0;
-    }
-    for (int i = 0; i < rows_; ++i) {
-        for (int j = 0; j < cols_; ++j) {
-            int o = cells_[i][j].owner;
-            if (o >= 0) score_[o]++;
-        }
-    }
+    score_ = owned_;
+}
+
+void Board::set_owner(const Pos& p, int pl) {
+    Cell& c = cell_priv(p);
+    if (c.owner >= 0) owned_[c.owner]--;
+    c.owner = pl;
+    owned_[pl]++;
 }
 
 string Board::version() {
@@ -328,10 +337,10 @@ void Board::print_preamble (ostream& os) const {
 }
 
 
-void Board::print (ostream& os) const {
-    os << endl;
+void Board::print (Writer& os) const {
+    os << '\n';
     
-    os << "round " << round() << endl;
+    os << "round " << round() << '\n';
     
     for (int i = 0; i < rows_; ++i) {
         for (int j = 0; j < cols_; ++j) {
@@ -340,16 +349,16 @@ void Board::print (ostream& os) const {
             else if (c.owner < 0) os << '.';
             else os << c.owner;
         }
-        os << endl;
+        os << '\n';
     }
 
     os << "score";
     for (int i = 0; i < nb_players(); ++i) os << " " << score_[i];
-    os << endl;
+    os << '\n';
     
     os << "status";
     for (int i = 0; i < nb_players(); ++i) os << " " << status_[i];
-    os << endl;
+    os << '\n';
     
     for (int id = 0; id < nb_units(); ++id) {
 
@@ -363,26 +372,43 @@ void Board::print (ostream& os) const {
             << unit(id).player << " "    
             << unit(id).pos.i << " "
             << unit(id).pos.j << " "
-            << unit(id).health << endl;
+            << unit(id).health << '\n';
 
     }
-    os << endl;
+    os << '\n';
 }
 
 
 
 
 void Board::print_debug (ostream& os) const {
-    print(os);
+    Writer w;
+    print(w);
+    w.write_to(os);
 }
 
 
 
 
-Board Board::next (const vector<Action>& as, Action& actions_done) const {
+void Board::catch_up (const Board& b) {
+    for (const Pos& p : b.changed_) cells_[p.i][p.j] = b.cells_[p.i][p.j];
+    changed_.clear();
+
+    round_ = b.round_;
+    units_ = b.units_;
+    score_ = b.score_;
+    status_ = b.status_;
+    owned_ = b.owned_;
+    farmers_by_player_ = b.farmers_by_player_;
+    knights_by_player_ = b.knights_by_player_;
+    vectors_by_player_updated_ = b.vectors_by_player_updated_;
+    rng_ = b.rng_;
+}
 
-    // b will be the new board we shall return
-    Board b = *this;
+void Board::next (const vector<Action>& as, Action& actions_done, Board& b) const {
+
+    // b will be the new board
+    b.catch_up(*this);
 
     // increment the round
     ++b.round_;
@@ -392,7 +418,7 @@ Board Board::next (const vector<Action>& as, Action& actions_done) const {
     for (int player = 0; player < nb_players(); ++player) {
         turns[player] = player;
     }
-    random_shuffle(turns.begin(), turns.end());
+    b.shuffle(turns);
 
     // move each unit
     vector<bool> moved(nb_units(), false);
@@ -404,11 +430,11 @@ Board Board::next (const vector<Action>& as, Action& actions_done) const {
             int id = m.i;
             Dir dir = m.d;
             if (!unit_ok(id)) {
-                cerr << "Id out of range" << endl;
+                _log_warning("Id out of range");
                 continue;
             }
             if (dir != None and dir != Left and dir != Right and dir != Top and dir != Bottom) {
-                cerr << "Direction not valid" << endl;
+                _log_warning("Direction not valid");
                 continue;
             }
             if (moved[id]) continue;
@@ -439,8 +465,6 @@ Board Board::next (const vector<Action>& as, Action& actions_done) const {
     }
 
     b.update_scores();
-
-    return b;
 }
 
 
@@ -458,8 +482,8 @@ bool Board::move (int player, int id, Dir d) {
     Pos p2 = dest(p1, d);
     if (not pos_ok(p2)) return false;
 
-    Cell& c1 = cells_[p1.i][p1.j];
-    Cell& c2 = cells_[p2.i][p2.j];
+    Cell& c1 = cell_priv(p1);
+    Cell& c2 = cell_priv(p2);
 
     if (c2.type == Wall) return false;
 
@@ -470,7 +494,7 @@ bool Board::move (int player, int id, Dir d) {
         Unit& u2 = units_[c2.unit];
         if (u2.player == u1.player) return false; //Trying to attack your own unit
         
-        int damage = damage_min_ + random() % (damage_max_ - damage_min_);
+        int damage = damage_min_ + randomize() % (damage_max_ - damage_min_);
         u2.health -= damage;
         if (u2.health <= 0) {
             u2.player = u1.player;
@@ -488,7 +512,7 @@ bool Board::move (int player, int id, Dir d) {
         u1.pos = p2;
         
         if (u1.type == Farmer) {
-            c2.owner = u1.player;
+            set_owner(p2, u1.player);
         }
         
         return true;
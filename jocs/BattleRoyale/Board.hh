@@ -3,6 +3,7 @@
 
 #include "Utils.hh"
 #include "PosDir.hh"
+#include "Writer.hh"
 class Action;
 
 using namespace std;
@@ -95,16 +96,25 @@ class Board {
     vector< vector<int> > farmers_by_player_;
     vector< vector<int> > knights_by_player_;
     bool vectors_by_player_updated_;
+
+    Random_generator rng_;
+
+    // Number of cells owned by each player.
+    vector<int> owned_;
+
+    // Positions of the cells written while computing this board (maybe repeated).
+    vector<Pos> changed_;
     
     /**
-     * Construct a board by reading first round from a stream.
+     * Construct a board by reading first round from a stream,
+     * with the given random seed.
      */
-    Board (istream& is, bool secgame);
+    Board (istream& is, bool secgame, int seed);
     
     /**
-     * Print the board to a stream.
+     * Print the board to a writer.
      */
-    void print (ostream& os) const;
+    void print (Writer& os) const;
     
     /**
      * Print the board preamble to a stream.
@@ -118,10 +128,31 @@ class Board {
     void print_debug (ostream& os) const;
 
     /**
-     * Computes the next board aplying the given actions as to the current board.
+     * Computes into b the next board aplying the given actions as to the current board.
      * It also returns the actual actions performed.
+     * b must be a copy of this board or the board this one was computed from,
+     * so that boards can be used alternately and only changed cells are copied.
+     */
+    void next (const vector<Action>& as, Action& actions_done, Board& b) const;
+
+    /**
+     * Makes this board equal to b, which must have been computed from this one
+     * (or be equal to it). Settings and names are not copied as they never change.
+     */
+    void catch_up (const Board& b);
+
+    /**
+     * Returns the cell at p, noting that it is written.
+     */
+    inline Cell& cell_priv (const Pos& p) {
+        changed_.push_back(p);
+        return cells_[p.i][p.j];
+    }
+
+    /**
+     * Makes player pl the owner of the cell at p.
      */
-    Board next (const vector<Action>& as, Action& actions_done) const;
+    void set_owner (const Pos& p, int pl);
 
     /**
      * Applies a basic move.
@@ -139,9 +170,24 @@ class Board {
     void update_vectors_by_player();
     
     /**
-     * Update scores
+     * Update scores, which are the number of cells owned by each player
      */
     void update_scores();
+
+    /**
+     * Sets the random seed.
+     */
+    inline void srandomize (int s) {
+        rng_.srandomize(s);
+    }
+
+    /**
+     * Randomly permutes a vector.
+     */
+    template <typename T>
+    void shuffle (vector<T>& v) {
+        for (int i = 0; i < sze(v); ++i) swap(v[i], v[i + randomize() % (sze(v) - i)]);
+    }
     
 public:
 
@@ -163,6 +209,13 @@ public:
         return secgame_;
     }
     
+    /**
+     * Returns a pseudo-random number between 0 and 2147483646.
+     */
+    inline int randomize () {
+        return rng_.randomize();
+    }
+
     /**
      * Returns the number of rounds for the game
      */
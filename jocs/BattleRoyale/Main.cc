@@ -15,6 +15,7 @@ void help (int argc, char** argv) {
     cout << "--input=file\t-i input\tset input file (default: stdin)" << endl;
     cout << "--output=file\t-o output\tset output file (default: stdout)" << endl;
     cout << "--list\t\t-l\t\tlist registered players" << endl;
+    cout << "--quiet\t\t-q\t\tonly log warnings and errors" << endl;
     cout << "--version\t-v\t\tprint version" << endl;
     cout << "--help\t\t-h\t\tprint help" << endl;
 }
@@ -40,6 +41,7 @@ int main (int argc, char** argv) {
         {"input",          required_argument,  0, 'i'},
         {"output",         required_argument,  0, 'o'},
         {"list",           no_argument,        0, 'l'},
+        {"quiet",          no_argument,        0, 'q'},
         {"version",        no_argument,        0, 'v'},
         {"help",           no_argument,        0, 'h'},
         {0, 0, 0, 0}
@@ -54,7 +56,7 @@ int main (int argc, char** argv) {
         int option_index = 0;
         int c = getopt_long(
             argc, argv,
-            "s:i:o:lvh",
+            "s:i:o:lqvh",
             long_options, &option_index
         );
 
@@ -78,6 +80,10 @@ int main (int argc, char** argv) {
                 Registry::print_players(cout);
                 return EXIT_SUCCESS;
 
+            case 'q':
+                Log::set_level(LOG_WARNING);
+                break;
+
             case 'v':
                 version();
                 return EXIT_SUCCESS;
@@ -95,12 +101,11 @@ int main (int argc, char** argv) {
     }
 
     if (seed < 0) seed = time(0);    
-    srand(seed);
 
     istream* is = ifile ? new ifstream(ifile) : &cin ;
     ostream* os = ofile ? new ofstream(ofile) : &cout;
         
-    Game::run(names, *is, *os);
+    Game::run(names, *is, *os, seed);
 
     if (ifile) delete is;
     if (ofile) delete os;
@@ -253,9 +253,9 @@ void Board::print_preamble (ostream& os) const {
 
 
 
-void Board::print (ostream& os) const {
-  os << endl;
-  os << "round " << round() << endl;
+void Board::print (Writer& os) const {
+  os << '\n';
+  os << "round " << round() << '\n';
   for (int i = 0; i < rows_; ++i) {
     for (int j = 0; j < cols_; ++j) {
       CType c = cell(i, j).type;
@@ -269,14 +269,14 @@ void Board::print (ostream& os) const {
       default     : _unreachable();
       };
     }
-    os << endl;
+    os << '\n';
   }
-  os << "beans" << endl;
+  os << "beans" << '\n';
   for (int i = 0; i < nb_beans_; ++i)
-    os <<   beans_[i].pos.i << " " <<   beans_[i].pos.j << " " <<   (beans_[i].present ? 'y': 'n') << " " <<   beans_[i].time << endl;
-  os << "kintons" << endl;
+    os <<   beans_[i].pos.i << " " <<   beans_[i].pos.j << " " <<   (beans_[i].present ? 'y': 'n') << " " <<   beans_[i].time << '\n';
+  os << "kintons" << '\n';
   for (int i = 0; i < nb_kintons_; ++i)
-    os << kintons_[i].pos.i << " " << kintons_[i].pos.j << " " << (kintons_[i].present ? 'y': 'n') << " " << kintons_[i].time << endl;
+    os << kintons_[i].pos.i << " " << kintons_[i].pos.j << " " << (kintons_[i].present ? 'y': 'n') << " " << kintons_[i].time << '\n';
   for (int id = 0; id < nb_players(); ++id) {
     const Goku& g = goku(id);
     string s;
@@ -296,17 +296,30 @@ void Board::print (ostream& os) const {
 	<< g.strength            << " "
 	<< g.kinton              << " "
 	<< fixed << setprecision(3) << status_[id]           << " "
-	<< endl;
+	<< '\n';
   }
-  os << endl;
+  os << '\n';
 }
 
-Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
+void Board::catch_up (const Board& b) {
+  for (const Pos& p : b.changed_)
+    cells_[p.i][p.j] = b.cells_[p.i][p.j];
+  changed_.clear();
+
+  round_   = b.round_;
+  gokus_   = b.gokus_;
+  kintons_ = b.kintons_;
+  beans_   = b.beans_;
+  status_  = b.status_;
+  nb_balls_to_be_placed_ = b.nb_balls_to_be_placed_;
+  rng_     = b.rng_;
+}
 
-  assert(ok());
 
-  // b will be the new board we shall return
-  Board b = *this;
+void Board::next (const vector<Action>& asked, vector<Action>& done, Board& b) const {
+
+  // b will be the new board
+  b.catch_up(*this);
 
   // increment the round
   ++b.round_;
@@ -315,11 +328,7 @@ Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
   b.nb_balls_to_be_placed_ = 0;
 
   // randomize turns
-  vector<int> turns(nb_players());
-  for (int player = 0; player < nb_players(); ++player) {
-    turns[player] = player;
-  }
-  random_shuffle(turns.begin(), turns.end());
+  vector<int> turns = b.random_permutation(nb_players());
 
   // handle kame hames of gokus
   for (int turn = 0; turn < nb_players(); ++turn) {
@@ -331,7 +340,7 @@ Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
 
     const Goku& g = gokus_[player];
     if (g.strength >= kamehame_penalty()) {
-      int outcome = randomize() % (max_strength() - kamehame_penalty() + 1);
+      int outcome = b.randomize() % (max_strength() - kamehame_penalty() + 1);
       int allowed = g.strength - kamehame_penalty();
       if (outcome <= allowed) {
 	bool throw_ok = b.apply_throw(player, a, d);
@@ -378,13 +387,13 @@ Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
       if (g.time == 0 and round() % 2 == 1) {
 	bool fnd = false;
 	for (int reps = 0; reps < 200 and not fnd; ++reps) {
-	  Pos p = Pos(randomize() % rows(), randomize() % cols());
+	  Pos p = Pos(b.randomize() % rows(), b.randomize() % cols());
 	  fnd = (b.cell(p).type == Empty);
 	  for (int ii = -2; fnd and ii <= 2; ++ii)
 	    for (int jj = -2; fnd and jj <= 2; ++jj)
 	      fnd = (not b.pos_ok(p.i + ii, p.j + jj)) or b.cell(p.i + ii, p.j + jj).id == -1;
 	  if (fnd) {
-	    b.cells_[p.i][p.j].id = player;
+	    b.cell_priv(p).id = player;
 	    g.pos   = p;
 	    g.type  = Normal;
 	    g.strength = b.res_strength_;
@@ -392,7 +401,7 @@ Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
 	    g.alive = true;
 	  }
 	}
-	if (not fnd) cerr << "info: cannot place goku on board." << endl;
+	if (not fnd) _log_info("cannot place goku on board.");
       }
     }
   }
@@ -405,7 +414,7 @@ Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
     if (m.time == 0 and b.cell(p).type == Empty and b.cell(p).id == -1) {
       assert(not m.present);
       m.present = true;
-      b.cells_[p.i][p.j].type = Bean;
+      b.cell_priv(p).type = Bean;
     }
   }
 
@@ -417,7 +426,7 @@ Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
     if (k.time == 0 and b.cell(p).type == Empty and b.cell(p).id == -1) {
       assert(not k.present);
       k.present = true;
-      b.cells_[p.i][p.j].type = Kinton;
+      b.cell_priv(p).type = Kinton;
     }
   }
 
@@ -427,8 +436,12 @@ Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
     assert(placed);
   }
 
-  assert(b.ok());
-  return b;
+  if (Check::full(b.round())) {
+    check(b.ok());
+  }
+  else if (Check::enabled()) {
+    check(b.touched_ok());
+  }
 }
 
 
@@ -453,7 +466,7 @@ bool Board::apply_throw(int id, AType a, Dir d) {
 	assert(cell(p).id != id);
 	Goku& g2 = gokus_[cell(p).id];
 	assert(g2.alive);
-	cells_[p.i][p.j].id = -1;
+	cell_priv(p).id = -1;
 	if (has_ball(g2.type))
 	  ++nb_balls_to_be_placed_;
 
@@ -462,7 +475,7 @@ bool Board::apply_throw(int id, AType a, Dir d) {
 	g2.kinton   = 0;
 	g2.alive    = false;
 	g2.time     = goku_regen_time();
-	cells_[p.i][p.j].id = -1;
+	cell_priv(p).id = -1;
       }
       p = dest(p, d);
     }
@@ -485,10 +498,10 @@ bool Board::apply_move(int id, AType a, Dir d) {
   Pos p2 = dest(p1, d);
   if (not pos_ok(p2)) return false;
 
-  Cell& c1 = cells_[p1.i][p1.j];
+  Cell& c1 = cell_priv(p1);
   assert(c1.id == id);
 
-  Cell& c2 = cells_[p2.i][p2.j];
+  Cell& c2 = cell_priv(p2);
 
   if (c2.type == Rock) return false;
 
@@ -610,6 +623,14 @@ bool Board::apply_move(int id, AType a, Dir d) {
 }
 
 
+vector<int> Board::random_permutation (int n) {
+  vector<int> v(n);
+  for (int i = 0; i < n; ++i) v[i] = i;
+  for (int i = 0; i < n; ++i) swap(v[i], v[i + randomize() % (n - i)]);
+  return v;
+}
+
+
 bool Board::place_new_ball(void) {
   for (int reps = 0; reps < 200; ++reps) {
     Pos p = Pos(randomize() % rows(), randomize() % cols());
@@ -627,11 +648,11 @@ bool Board::place_new_ball(void) {
       bok = (p != beans_[k].pos);
 
     if (bok) {
-      cells_[p.i][p.j].type = Ball;
+      cell_priv(p).type = Ball;
       return true;
     }
   }
-  cerr << "info: cannot place ball on board." << endl;
+  _log_info("cannot place ball on board.");
   return false;
 }
 
@@ -639,31 +660,31 @@ bool Board::place_new_ball(void) {
 bool Board::ok(void) const {
 
   if (int(cells_.size()) != rows_) {
-    cerr << "debug: problems with row dimension of the board." << endl;
+    _log_error("problems with row dimension of the board.");
     return false;
   }
   if (int(cells_[0].size()) != cols_) {
-    cerr << "debug: problems with col dimension of the board." << endl;
+    _log_error("problems with col dimension of the board.");
     return false;
   }
   if (int(gokus_.size()) != nb_players_) {
-    cerr << "debug: problems with number of players (1)." << endl;
+    _log_error("problems with number of players (1).");
     return false;
   }
   if (int(status_.size()) != nb_players_) {
-    cerr << "debug: problems with number of players (2)." << endl;
+    _log_error("problems with number of players (2).");
     return false;
   }
   if (int(names_.size()) != nb_players_) {
-    cerr << "debug: problems with number of players (3)." << endl;
+    _log_error("problems with number of players (3).");
     return false;
   }
   if (int(kintons_.size()) != nb_kintons_) {
-    cerr << "debug: wrong size of vector of kintons." << endl;
+    _log_error("wrong size of vector of kintons.");
     return false;
   }
   if (int(beans_.size()) != nb_beans_) {
-    cerr << "debug: wrong size of vector of beans." << endl;
+    _log_error("wrong size of vector of beans.");
     return false;
   }
 
@@ -671,7 +692,7 @@ bool Board::ok(void) const {
   for (int k = 0; k < nb_kintons(); ++k) s.insert(kintons_[k].pos);
   for (int k = 0; k < nb_beans()  ; ++k) s.insert(  beans_[k].pos);
   if (int(s.size()) != nb_kintons() + nb_beans()) {
-    cerr << "debug: overlapping of kintons and beans." << endl;
+    _log_error("overlapping of kintons and beans.");
     return false;
   }
 
@@ -682,24 +703,24 @@ bool Board::ok(void) const {
     for (int j = 0; j < cols(); ++j) {
 
       if (cells_[i][j].pos != Pos(i, j)) {
-	cerr << "debug: problem with positions in cells." << endl;
+	_log_error("problem with positions in cells.");
 	return false;
       }
 
       if (i == 0          and cells_[i][j].type != Rock) {
-	cerr << "debug: borders of board should be rocks (1)." << endl;
+	_log_error("borders of board should be rocks (1).");
 	return false;
       }
       if (i == rows() - 1 and cells_[i][j].type != Rock) {
-	cerr << "debug: borders of board should be rocks (2)." << endl;
+	_log_error("borders of board should be rocks (2).");
 	return false;
       }
       if (j == 0          and cells_[i][j].type != Rock) {
-	cerr << "debug: borders of board should be rocks (3)." << endl;
+	_log_error("borders of board should be rocks (3).");
 	return false;
       }
       if (j == cols() - 1 and cells_[i][j].type != Rock) {
-	cerr << "debug: borders of board should be rocks (4)." << endl;
+	_log_error("borders of board should be rocks (4).");
 	return false;
       }
       switch (cells_[i][j].type) {
@@ -711,20 +732,20 @@ bool Board::ok(void) const {
       int id = cells_[i][j].id;
       if (id != -1) {
 	if (id < -1 or id > nb_players_) {
-	  cerr << "debug: problem with players in cells." << endl;
+	  _log_error("problem with players in cells.");
 	  return false;
 	}
 	if (players_set.count(id) == 1) {
-	  cerr << "debug: players are repeated on board." << endl;
+	  _log_error("players are repeated on board.");
 	  return false;
 	}
 	players_set.insert(id);
 	if (gokus_[id].pos != Pos(i,j)) {
-	  cerr << "debug: wrong position in goku." << endl;
+	  _log_error("wrong position in goku.");
 	  return false;
 	}
 	if (not gokus_[id].alive) {
-	  cerr << "debug: goku should be alive." << endl;
+	  _log_error("goku should be alive.");
 	  return false;
 	}
       }
@@ -734,14 +755,14 @@ bool Board::ok(void) const {
   for (int id = 0; id < nb_players_; ++id) {
     if (players_set.count(id) == 0) {
       if (gokus_[id].alive) {
-	cerr << "debug: goku should be dead." << endl;
+	_log_error("goku should be dead.");
 	return false;
       }
     }
   }
 
   if (n_capsules != nb_capsules()) {
-    cerr << "debug: wrong number of capsules." << endl;
+    _log_error("wrong number of capsules.");
     return false;
   }
 
@@ -751,91 +772,91 @@ bool Board::ok(void) const {
     if (g.alive and has_ball(g.type)) ++n_gokus_with_ball;
   }
   if (n_gokus_with_ball + n_balls_not_taken != nb_balls()) {
-    cerr << "debug: wrong number of balls." << endl;
+    _log_error("wrong number of balls.");
     return false;
   }
 
   for (int id = 0; id < nb_players_; ++id) {
     const Goku& g = gokus_[id];
     if (g.id != id) {
-      cerr << "debug: goku has wrong identifier." << endl;
+      _log_error("goku has wrong identifier.");
       return false;
     }
     if (not pos_ok(g.pos)) {
-      cerr << "debug: problem with position of goku (1)." << endl;
+      _log_error("problem with position of goku (1).");
       return false;
     }
     if (not g.alive and g.kinton != 0) {
-      cerr << "debug: invalid state for a dead goku (1)." << endl;
+      _log_error("invalid state for a dead goku (1).");
       return false;
     }
     if (not g.alive and g.strength != 0) {
-      cerr << "debug: invalid state for a dead goku (2)." << endl;
+      _log_error("invalid state for a dead goku (2).");
       return false;
     }
     if (not g.alive and g.type != Normal) {
-      cerr << "debug: invalid state for a dead goku (3)." << endl;
+      _log_error("invalid state for a dead goku (3).");
       return false;
     }
     if (g.alive and cell(g.pos).id != id) {
-      cerr << "debug: problem with position of goku (2)." << endl;
+      _log_error("problem with position of goku (2).");
       return false;
     }
     if (g.alive and cell(g.pos).type == Rock) {
-      cerr << "debug: goku cannot be in rock." << endl;
+      _log_error("goku cannot be in rock.");
       return false;
     }
     if (g.alive and cell(g.pos).type == Capsule and has_ball(g.type)) {
-      cerr << "debug: goku should have left the ball." << endl;
+      _log_error("goku should have left the ball.");
       return false;
     }
     if (g.alive and cell(g.pos).type == Ball and not has_ball(g.type)) {
-      cerr << "debug: goku should have taken the ball." << endl;
+      _log_error("goku should have taken the ball.");
       return false;
     }
     if (g.alive and cell(g.pos).type == Kinton) {
-      cerr << "debug: goku should have jumped on kinton cloud." << endl;
+      _log_error("goku should have jumped on kinton cloud.");
       return false;
     }
     if (g.alive and cell(g.pos).type == Bean) {
-      cerr << "debug: goku should have eaten magic bean." << endl;
+      _log_error("goku should have eaten magic bean.");
       return false;
     }
     if (g.balls < 0) {
-      cerr << "debug: number of balls cannot be negative." << endl;
+      _log_error("number of balls cannot be negative.");
       return false;
     }
     if (g.strength < 0) {
-      cerr << "debug: strength cannot be negative." << endl;
+      _log_error("strength cannot be negative.");
       return false;
     }
     if (g.strength > max_strength()) {
-      cerr << "debug: strength cannot exceed max value." << endl;
+      _log_error("strength cannot exceed max value.");
       return false;
     }
     if (g.kinton < 0) {
-      cerr << "debug: kinton life time cannot be negative." << endl;
+      _log_error("kinton life time cannot be negative.");
       return false;
     }
     if (has_kinton(g.type) and g.kinton == 0) {
-      cerr << "debug: goku should not be on kinton." << endl;
+      _log_error("goku should not be on kinton.");
       return false;
     }
     if (not has_kinton(g.type) and g.kinton > 0) {
-      cerr << "debug: goku should be on kinton." << endl;
+      _log_error("goku should be on kinton.");
       return false;
     }
 
     if (g.time < 0) {
-      cerr << "debug: regeneration time cannot be negative." << endl;
+      _log_error("regeneration time cannot be negative.");
       return false;
     }
     if (g.time > goku_regen_time()) {
-      cerr << "debug: regeneration time cannot exceed max value." << endl;
+      _log_error("regeneration time cannot exceed max value.");
       return false;
     }
     if (g.alive and g.time > 0) {
-      cerr << "debug: live goku cannot have non-null regeneration time." << endl;
+      _log_error("live goku cannot have non-null regeneration time.");
       return false;
     }
   }
@@ -843,27 +864,27 @@ bool Board::ok(void) const {
   for (int k = 0; k < nb_kintons(); ++k) {
     Pos p = kintons_[k].pos;
     if (not pos_ok(p)) {
-      cerr << "debug: invalid position of a kinton cloud." << endl;
+      _log_error("invalid position of a kinton cloud.");
       return false;
     }
     if (kintons_[k].present and kintons_[k].time > 0) {
-      cerr << "debug: regeneration time of kinton should be null." << endl;
+      _log_error("regeneration time of kinton should be null.");
       return false;
     }
     if (not kintons_[k].present and kintons_[k].time == 0 and cell(p).id == -1) {
-      cerr << "debug: kinton should be present." << endl;
+      _log_error("kinton should be present.");
       return false;
     }
     if (cell(p).type != Empty and cell(p).type != Kinton) {
-      cerr << "debug: problems with cells and kintons (1)." << endl;
+      _log_error("problems with cells and kintons (1).");
       return false;
     }
     if (cell(p).type == Empty and kintons_[k].present) {
-      cerr << "debug: problems with cells and kintons (2)." << endl;
+      _log_error("problems with cells and kintons (2).");
       return false;
     }
     if (cell(p).type == Kinton and not kintons_[k].present) {
-      cerr << "debug: problems with cells and kintons (3)." << endl;
+      _log_error("problems with cells and kintons (3).");
       return false;
     }
   }
@@ -871,27 +892,88 @@ bool Board::ok(void) const {
   for (int k = 0; k < nb_beans(); ++k) {
     Pos p = beans_[k].pos;
     if (not pos_ok(p)) {
-      cerr << "debug: invalid position of a bean cloud." << endl;
+      _log_error("invalid position of a bean cloud.");
       return false;
     }
     if (beans_[k].present and beans_[k].time > 0) {
-      cerr << "debug: regeneration time of bean should be null." << endl;
+      _log_error("regeneration time of bean should be null.");
       return false;
     }
     if (not beans_[k].present and beans_[k].time == 0 and cell(p).id == -1) {
-      cerr << "debug: bean should be present." << endl;
+      _log_error("bean should be present.");
       return false;
     }
     if (cell(p).type != Empty and cell(p).type != Bean) {
-      cerr << "debug: problems with cells and beans (1)." << endl;
+      _log_error("problems with cells and beans (1).");
       return false;
     }
     if (cell(p).type == Empty and beans_[k].present) {
-      cerr << "debug: problems with cells and beans (2)." << endl;
+      _log_error("problems with cells and beans (2).");
       return false;
     }
     if (cell(p).type == Bean and not beans_[k].present) {
-      cerr << "debug: problems with cells and beans (3)." << endl;
+      _log_error("problems with cells and beans (3).");
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+bool Board::touched_ok(void) const {
+
+  for (const Pos& p : changed_) {
+    const Cell& c = cells_[p.i][p.j];
+    if (c.pos != p) {
+      _log_error("problem with positions in cells.");
+      return false;
+    }
+    if (c.id < -1 or c.id >= nb_players_) {
+      _log_error("problem with players in cells.");
+      return false;
+    }
+    if (c.id != -1) {
+      const Goku& g = gokus_[c.id];
+      if (g.pos != p) {
+        _log_error("wrong position in goku.");
+        return false;
+      }
+      if (not g.alive) {
+        _log_error("goku should be alive.");
+        return false;
+      }
+      if (c.type == Rock) {
+        _log_error("goku cannot be in rock.");
+        return false;
+      }
+    }
+  }
+
+  for (int id = 0; id < nb_players_; ++id) {
+    const Goku& g = gokus_[id];
+    if (not pos_ok(g.pos)) {
+      _log_error("problem with position of goku (1).");
+      return false;
+    }
+    if (g.alive and cell(g.pos).id != id) {
+      _log_error("problem with position of goku (2).");
+      return false;
+    }
+    if (not g.alive and (g.kinton != 0 or g.strength != 0 or g.type != Normal)) {
+      _log_error("invalid state for a dead goku.");
+      return false;
+    }
+    if (g.strength < 0 or g.strength > max_strength()) {
+      _log_error("strength out of range.");
+      return false;
+    }
+    if (has_kinton(g.type) != (g.kinton > 0)) {
+      _log_error("kinton life time does not match the type of goku.");
+      return false;
+    }
+    if (g.time < 0 or g.time > goku_regen_time() or (g.alive and g.time > 0)) {
+      _log_error("wrong regeneration time of goku.");
       return false;
     }
   }
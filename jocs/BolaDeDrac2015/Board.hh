@@ -3,6 +3,8 @@
 
 #include "Utils.hh"
 #include "PosDir.hh"
+#include "Writer.hh"
+#include "Check.hh"
 #include "Action.hh"
 
 using namespace std;
@@ -196,6 +198,11 @@ class Board {
 
   int nb_balls_to_be_placed_;
 
+  Random_generator rng_;
+
+  // Positions of the cells written while computing this board (maybe repeated).
+  vector<Pos> changed_;
+
   /**
    * Construct a board by reading first round from a stream.
    */
@@ -207,15 +214,31 @@ class Board {
   void print_preamble (ostream& os) const;
 
   /**
-   * Print the board to a stream.
+   * Print the board to a writer.
    */
-  void print (ostream& os) const;
+  void print (Writer& os) const;
 
   /**
-   * Computes the next board applying the given actions as to the current board.
+   * Computes into b the next board applying the given actions to the current board.
    * It also returns the actual actions performed.
+   * b must be a copy of this board or the board this one was computed from,
+   * so that boards can be used alternately and only changed cells are copied.
+   */
+  void next (const vector<Action>& asked, vector<Action>& done, Board& b) const;
+
+  /**
+   * Makes this board equal to b, which must have been computed from this one
+   * (or be equal to it). Settings and names are not copied as they never change.
+   */
+  void catch_up (const Board& b);
+
+  /**
+   * Returns the cell at p, noting that it is written.
    */
-  Board next (const vector<Action>& asked, vector<Action>& done) const;
+  inline Cell& cell_priv (const Pos& p) {
+    changed_.push_back(p);
+    return cells_[p.i][p.j];
+  }
 
   /**
    * Applies a kamehame throw. Returns true if the action can be done.
@@ -232,11 +255,29 @@ class Board {
    */
   bool place_new_ball(void);
 
+  /**
+   * Sets the random seed.
+   */
+  inline void srandomize (int s) {
+    rng_.srandomize(s);
+  }
+
+  /**
+   * Returns a random permutation of {0, 1, ..., n-1}.
+   */
+  vector<int> random_permutation (int n);
+
   /**
    * Checks invariants of the board. For debugging.
    */
   bool ok(void) const;
 
+  /**
+   * Checks the invariants that concern the cells written while computing
+   * this board and the gokus.
+   */
+  bool touched_ok(void) const;
+
   /**
    * Returns a reference to the current cpu status of a player.
    */
@@ -261,6 +302,14 @@ public:
   {   }
 
 
+  /**
+   * Returns a pseudo-random number between 0 and RANDOMIZE_MAX.
+   */
+  inline int randomize () {
+    return rng_.randomize();
+  }
+
+
   /**
    * Returns the number of rounds in the game.
    */
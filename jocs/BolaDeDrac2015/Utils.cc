@@ -1,3 +1 @@
 #include "Utils.hh"
-
-long rnd_seed = RANDOMIZE_DEFAULT;
@@ -19,6 +19,7 @@
 #include <sys/resource.h>
 
 #include "BackTrace.hh"
+#include "Log.hh"
 
 using namespace std;
 
@@ -30,7 +31,7 @@ using namespace std;
  * (somehow adapted from err.h and error.h)
  */
 
-#define myerror_at_line(status, error, file, line, ...) { fprintf(stderr, "Error at %s:%i: ", file, line); fprintf(stderr, __VA_ARGS__); if (error) perror(" errno"); fprintf(stderr, "\n"); exit(status); }
+#define myerror_at_line(status, error, file, line, ...) { Log::flush(); fprintf(stderr, "Error at %s:%i: ", file, line); fprintf(stderr, __VA_ARGS__); if (error) perror(" errno"); fprintf(stderr, "\n"); exit(status); }
 #define myerr(...) myerror_at_line(EXIT_FAILURE, errno, __FILE__, __LINE__, __VA_ARGS__)
 #define myerrx(...) myerror_at_line(EXIT_FAILURE, 0, __FILE__, __LINE__, __VA_ARGS__)
 
@@ -141,27 +142,39 @@ const int RANDOMIZE_MODULUS    = 2147483647;
 const int RANDOMIZE_MULTIPLIER = 48271;
 const int RANDOMIZE_DEFAULT    = 123456789;  // Initial seed.
 const int RANDOMIZE_MAX        = RANDOMIZE_MODULUS - 2;
-      
-extern long rnd_seed;
 
-// Sets random seed.
-inline void srandomize(int s = RANDOMIZE_DEFAULT) {
-  if (s < 0) s = -s;
-  rnd_seed = 1 + s % (RANDOMIZE_MODULUS - 1);
-}
+// Pseudo-random generator. Each board and each player has its own one,
+// so that games only depend on their seed.
+class Random_generator {
 
-// Returns pseudo-random number between 0 and RANDOMIZE_MAX
-inline int randomize(void) {
-  const long Q = RANDOMIZE_MODULUS / RANDOMIZE_MULTIPLIER;
-  const long R = RANDOMIZE_MODULUS % RANDOMIZE_MULTIPLIER;
-        long t;
-
-  t = RANDOMIZE_MULTIPLIER * (rnd_seed % Q) - R * (rnd_seed / Q);
-  if (t > 0) 
-    rnd_seed = t;
-  else 
-    rnd_seed = t + RANDOMIZE_MODULUS;
-  return rnd_seed - 1;
-}
+  long rnd_seed;
+
+public:
+
+  Random_generator () {
+    srandomize();
+  }
+
+  // Sets random seed.
+  void srandomize(int s = RANDOMIZE_DEFAULT) {
+    if (s < 0) s = -s;
+    rnd_seed = 1 + s % (RANDOMIZE_MODULUS - 1);
+  }
+
+  // Returns pseudo-random number between 0 and RANDOMIZE_MAX
+  int randomize(void) {
+    const long Q = RANDOMIZE_MODULUS / RANDOMIZE_MULTIPLIER;
+    const long R = RANDOMIZE_MODULUS % RANDOMIZE_MULTIPLIER;
+          long t;
+
+    t = RANDOMIZE_MULTIPLIER * (rnd_seed % Q) - R * (rnd_seed / Q);
+    if (t > 0) 
+      rnd_seed = t;
+    else 
+      rnd_seed = t + RANDOMIZE_MODULUS;
+    return rnd_seed - 1;
+  }
+
+};
 
 #endif
@@ -14,7 +14,7 @@ Action::Action (istream& is) {
       v_.push_back(Movement(i, c2d(d)));
     }
     else {
-      cerr << "warning: only half an operation given for unit " << i << endl;
+      _log_warning("only half an operation given for unit " << i);
       return;
     }
   }
@@ -1,14 +1,18 @@
 #include "Board.hh"
 #include "Action.hh"
 
+#include <thread>
+#include <unistd.h>
+
 
 void Board::capture (int id, int pl, vector<bool>& killed) {
   Unit& u = unit_[id];
   _my_assert(u.player != pl, "Capturing own unit.");
 
+  grid_[u.pos.i][u.pos.j].id = -1;
+  presence(id, u.pos, -1);
   u.player = pl;
   u.health = (u.type == Farmer ? farmers_health() : knights_health());
-  grid_[u.pos.i][u.pos.j].id = -1;
   killed[id] = true;
 }
 
@@ -21,6 +25,8 @@ void Board::step (int id, Pos p2) {
   c1.id = -1;
   c2.id = id;
   u.pos = p2;
+  presence(id, p1, -1);
+  presence(id, p2, 1);
 }
 
 
@@ -47,6 +53,88 @@ void Board::spell (int id, vector<bool>& killed) {
 }
 
 
+void Board::haunt (Pos p, int d, vector<Pos>& touched) {
+  for (int x = -2; x <= 2; ++x)
+    for (int y = -2; y <= 2; ++y)
+      if (abs(x) + abs(y) <= 2) {
+        Pos q = p + Pos(x, y);
+        if (pos_ok(q)) {
+          haunters_[q.i][q.j] += d;
+          touched.push_back(q);
+        }
+      }
+}
+
+
+bool Board::witch_active (int id) const {
+  for (int x = -2; x <= 2; ++x)
+    for (int y = -2; y <= 2; ++y)
+      if ((x or y) and abs(x) + abs(y) <= 2) {
+        Pos p = unit(id).pos + Pos(x, y);
+        if (pos_ok(p)) {
+          int id2 = cell(p).id;
+          if (id2 != -1 and unit(id2).type == Witch) return false;
+        }
+      }
+  return true;
+}
+
+
+void Board::init_haunted () {
+  haunters_ = vector< vector<int> >(rows(), vector<int>(cols(), 0));
+  vector<Pos> touched;
+  for (int pl = 0; pl < nb_players(); ++pl)
+    for (int id : witches_[pl]) {
+      unit_[id].active = witch_active(id);
+      if (unit(id).active) haunt(unit(id).pos, 1, touched);
+    }
+
+  for (int i = 0; i < rows(); ++i)
+    for (int j = 0; j < cols(); ++j)
+      grid_[i][j].haunted = haunters_[i][j] > 0;
+}
+
+
+void Board::move_witch (int id, Pos p2, vector<bool>& killed) {
+  Pos p1 = unit(id).pos;
+
+  vector<int> near(1, id);
+  for (int pl = 0; pl < nb_players(); ++pl)
+    for (int w : witches_[pl]) {
+      Pos p = unit(w).pos;
+      if (w != id and (abs(p.i - p1.i) + abs(p.j - p1.j) <= 2 or
+                       abs(p.i - p2.i) + abs(p.j - p2.j) <= 2))
+        near.push_back(w);
+    }
+
+  vector<Pos> touched;
+  for (int w : near)
+    if (unit(w).active) haunt(unit(w).pos, -1, touched);
+
+  step(id, p2);
+
+  for (int w : near) {
+    unit_[w].active = witch_active(w);
+    if (unit(w).active) haunt(unit(w).pos, 1, touched);
+  }
+
+  vector<Pos> haunted;
+  for (Pos p : touched) {
+    Cell& c = grid_[p.i][p.j];
+    bool h = haunters_[p.i][p.j] > 0;
+    if (h and not c.haunted) haunted.push_back(p);
+    c.haunted = h;
+  }
+
+  // Spells are random, so they are cast in the order of a scan of the grid.
+  sort(haunted.begin(), haunted.end());
+  for (Pos p : haunted) {
+    int id2 = cell(p).id;
+    if (id2 != -1 and unit(id2).type != Witch) spell(id2, killed);
+  }
+}
+
+
 // id is a valid unit id, moved by its player, and d is a valid dir != None.
 bool Board::move (int id, Dir dir, vector<bool>& killed) {
   Unit& u = unit_[id];
@@ -65,15 +153,7 @@ bool Board::move (int id, Dir dir, vector<bool>& killed) {
   int id2 = c2.id;
   if (id2 == -1) {
     if (u.type == Witch) {
-      step(id, p2);
-      update_haunted();
-
-      for (int i = 0; i < rows(); ++i)
-        for (int j = 0; j < cols(); ++j) {
-          int id = cell(i, j).id;
-          if (id != -1 and cell(i, j).haunted and unit(id).type != Witch)
-            spell(id, killed);
-        }
+      move_witch(id, p2, killed);
       return true;
     }
 
@@ -165,23 +245,42 @@ bool Board::pos_witch_ok (int i, int j) const {
 }
 
 
-inline bool Board::ok_cell (int pl, Pos pos, bool knight) const {
-  if (not pos_witch_ok(pos.i, pos.j)) return false;
+void Board::init_near () {
+  _my_assert(nb_players() == 4, "Surroundings are kept for 4 players.");
+  near_ = vector< vector<Near> >(rows(), vector<Near>(cols(), Near()));
+}
+
+
+void Board::presence (int id, Pos p, int d) {
+  const Unit& u = unit(id);
+  if (u.type == Witch)
+    for (int x = -3; x <= 3; ++x)
+      for (int y = -3; y <= 3; ++y)
+        if (abs(x) + abs(y) <= 3) {
+          Pos q = p + Pos(x, y);
+          if (pos_ok(q)) near_[q.i][q.j].witches += d;
+        }
 
-  if (knight) {
-    for (int d = 0; d < 8; ++d) {
-      int id = cell(pos + Dir(d)).id;
-      if (id != -1 and unit(id).player != pl) return false;
+  for (int k = 0; k < 8; ++k) {
+    Pos q = p + Dir(k);
+    if (pos_ok(q)) {
+      Near& n = near_[q.i][q.j];
+      n.units += d;
+      n.units_of[u.player] += d;
+      if (u.type == Knight and k%2 == 0) {
+        n.knights += d;
+        n.knights_of[u.player] += d;
+      }
     }
-    return true;
   }
+}
 
-  for (int d = 0; d < 8; d += 2) {
-    int id = cell(pos + Dir(d)).id;
-    if (id != -1 and unit(id).player != pl and unit(id).type == Knight)
-      return false;
-  }
-  return true;
+
+inline bool Board::spawnable (int pl, Pos p, bool knight) const {
+  const Near& n = near_[p.i][p.j];
+  if (not available(p.i, p.j) or n.witches > 0) return false;
+  if (knight) return n.units == n.units_of[pl];
+  else        return n.knights == n.knights_of[pl];
 }
 
 
@@ -189,6 +288,7 @@ void Board::place (int id, Pos p) {
   unit_[id].pos = p;
   grid_[p.i][p.j].id = id;
   if (unit(id).type == Farmer) grid_[p.i][p.j].owner = unit(id).player;
+  presence(id, p, 1);
 }
 
 
@@ -222,15 +322,15 @@ void Board::spawn_units (int pl, const vector<int>& uni, vector<int>& extra) {
   vector<Pos> pos;
   for (int i = mini; i <= maxi; ++i)
     for (int j = minj; j <= maxj; ++j)
-      if (ok_cell(pl, Pos(i, j), knight)) pos.push_back(Pos(i, j));
+      if (spawnable(pl, Pos(i, j), knight)) pos.push_back(Pos(i, j));
 
   spawn(pos, uni, 0);
 
   int num_u = uni.size();
   int num_p = pos.size();
   if (num_u > num_p) {
-    cerr << "warning: more " << (knight ? "knights" : "farmers")
-         << " than good reborn positions for player " << pl << endl;
+    _log_warning("more " << (knight ? "knights" : "farmers")
+                 << " than good reborn positions for player " << pl);
 
     vector<Pos> pos2;
     for (int i = mini; i <= maxi; ++i)
@@ -241,8 +341,8 @@ void Board::spawn_units (int pl, const vector<int>& uni, vector<int>& extra) {
 
     int num_p2 = pos2.size();
     if (num_u > num_p + num_p2) {
-      cerr << "warning: more " << (knight ? "knights" : "farmers")
-           << " than free reborn positions for player " << pl << endl;
+      _log_warning("more " << (knight ? "knights" : "farmers")
+                   << " than free reborn positions for player " << pl);
 
       for (int k = num_p + num_p2; k < num_u; ++k) extra.push_back(uni[k]);
     }
@@ -317,18 +417,38 @@ void Board::generate_units () {
 }
 
 
-Board::Board (istream& is, int seed) {
+Map Board::read_map (istream& is) {
+  Map m;
+  m.settings = Settings::read_settings(is);
+  is >> m.generator;
+  if (m.generator == "FIXED") {
+    Info info;
+    *static_cast<Settings*>(&info) = m.settings;
+    info.read_grid(is);
+    m.grid = info.grid_;
+  }
+  else {
+    int x;
+    while (is >> x) m.param.push_back(x);
+  }
+  return m;
+}
+
+
+Board::Board (const Map& m, int seed) {
   set_random_seed(seed);
-  *static_cast<Settings*>(this) = Settings::read_settings(is);
+  *static_cast<Settings*>(this) = m.settings;
   names_ = vector<string>(nb_players());
-  read_generator_and_grid(is);
+  make_grid(m);
   round_ = 0;
   land_ = vector<int>(nb_players(), 0);
   total_score_ = vector<int>(nb_players(), 0);
   cpu_status_ = vector<double>(nb_players(), 0);
   unit_ = vector<Unit>
           (nb_players()*(nb_farmers() + nb_knights() + nb_witches()));
+  init_near();
   generate_units();
+  init_haunted();
   update_vectors_by_player();
   compute_scores();
 }
@@ -359,8 +479,8 @@ void Board::print_names (ostream& os) const {
 }
 
 
-void Board::print_state (ostream& os) const {
-  os << endl << endl;
+void Board::print_state (Writer& os) const {
+  os << "\n\n";
 
   for (int i = 0; i < rows(); ++i) {
     for (int j = 0; j < cols(); ++j) {
@@ -370,26 +490,26 @@ void Board::print_state (ostream& os) const {
       else if (player_ok(c.owner)) os << c.owner;
       else assert(false);
     }
-    os << endl;
+    os << '\n';
   }
 
-  os << endl;
-  os << "round " << round() << endl;
+  os << '\n';
+  os << "round " << round() << '\n';
 
   os << "land";
   for (auto la : land_) os << " " << la;
-  os << endl;
+  os << '\n';
 
   os << "total_score";
   for (auto ts : total_score_) os << " " << ts;
-  os << endl;
+  os << '\n';
 
   os << "status";
   for (auto st : cpu_status_) os << " " << st;
-  os << endl;
+  os << '\n';
 
   for (int id = 0; id < nb_units(); ++id) print_unit(unit(id), os);
-  os << endl;
+  os << '\n';
 }
 
 
@@ -425,17 +545,17 @@ void Board::next (const vector<Action>& act, ostream& os) {
     for (const Movement& m : act[pl].v_) {
       int id = m.id;
       Dir dir = m.dir;
-      if (not unit_ok(id)) cerr << "warning: id out of range :" << id << endl;
+      if (not unit_ok(id)) _log_warning("id out of range :" << id);
       else if (unit(id).player != pl)
-        cerr << "warning: not own unit: " << id << ' ' << unit(id).player
-             << ' ' << pl << endl;
+        _log_warning("not own unit: " << id << ' ' << unit(id).player
+                     << ' ' << pl);
       else {
         _my_assert(not seen[id], "More than one command for the same unit.");
         seen[id] = true;
         if (not dir_ok(dir))
-          cerr << "warning: direction not valid: " << dir << endl;
+          _log_warning("direction not valid: " << dir);
         else if (dir%2 and unit(id).type != Knight)
-          cerr << "warning: not horizontal or vertical dir: " << dir << endl;
+          _log_warning("not horizontal or vertical dir: " << dir);
         else if (dir != None) {
           dir = Dir((dir + 2*pl)%8);
           v.push_back(Movement(id, dir));
@@ -470,22 +590,25 @@ void Board::next (const vector<Action>& act, ostream& os) {
     }
 
   // spawns units
-  vector< vector<int> > dead_f(nb_players());
-  vector< vector<int> > dead_k(nb_players());
-  for (int id = 0; id < nu; ++id)
-    if (killed[id]) {
-      UnitType t = unit(id).type;
-      assert(ut_ok(t));
-      _my_assert(t != Witch, "Witch killed.")
-      (t == Farmer ? dead_f : dead_k)[unit(id).player].push_back(id);
-    }
+  {
+    Profile::Timer timer(prof_, Profile::Spawn);
+    vector< vector<int> > dead_f(nb_players());
+    vector< vector<int> > dead_k(nb_players());
+    for (int id = 0; id < nu; ++id)
+      if (killed[id]) {
+        UnitType t = unit(id).type;
+        assert(ut_ok(t));
+        _my_assert(t != Witch, "Witch killed.")
+        (t == Farmer ? dead_f : dead_k)[unit(id).player].push_back(id);
+      }
 
-  vector<int> extra;
-  for (int pl = 0; pl < np; ++pl) spawn_units(pl, dead_k[pl], extra);
-  for (int pl = 0; pl < np; ++pl) spawn_units(pl, dead_f[pl], extra);
+    vector<int> extra;
+    for (int pl = 0; pl < np; ++pl) spawn_units(pl, dead_k[pl], extra);
+    for (int pl = 0; pl < np; ++pl) spawn_units(pl, dead_f[pl], extra);
 
-  // spawn extra units (for evil situations)
-  spawn_extras(extra);
+    // spawn extra units (for evil situations)
+    spawn_extras(extra);
+  }
 
   update_vectors_by_player();
 
@@ -503,6 +626,50 @@ void Board::initial (int r, int c) {
 }
 
 
+string Board::grid_key (const vector<int>& param) const {
+  ostringstream oss;
+  oss << version() << ' ' << generator_;
+  for (int x : param) oss << ' ' << x;
+  oss << " rows " << rows() << " cols " << cols() << " seed " << rnd_seed;
+  return oss.str();
+}
+
+
+bool Board::load_grid (const string& key) {
+  string file = Grid_cache::file(key);
+  ifstream ifs(file);
+  string line;
+  long long seed;
+  if (not getline(ifs, line) or line != key or not (ifs >> seed)) return false;
+
+  read_grid(ifs);
+  rnd_seed = seed;
+  _log_debug("grid read from " << file);
+  return true;
+}
+
+
+void Board::store_grid (const string& key) const {
+  // Written to a temporary file first, so that other games
+  // (maybe in other processes) never read half a grid.
+  string file = Grid_cache::file(key);
+  ostringstream tmp;
+  tmp << file << '.' << getpid() << '.' << this_thread::get_id();
+  ofstream ofs(tmp.str());
+  ofs << key << '\n' << rnd_seed << '\n';
+  for (int i = 0; i < rows(); ++i) {
+    for (int j = 0; j < cols(); ++j) ofs << (grid_[i][j].type == Wall ? 'X' : '.');
+    ofs << '\n';
+  }
+  ofs.close();
+
+  if (not ofs or rename(tmp.str().c_str(), file.c_str()) != 0) {
+    _log_warning("cannot write grid to " << file);
+    remove(tmp.str().c_str());
+  }
+}
+
+
 void Board::generator1 (vector<int> param) {
   int num = param.size();
   _my_assert(num >= 1 and num <= 2,
@@ -523,7 +690,7 @@ void Board::generator1 (vector<int> param) {
   initial(r, c);
 
   while (q) {
-    cerr << q << endl;
+    _log_debug("walls left " << q);
     int i = random(2, r - 3);
     int j = random(2, c - 3);
     bool ok = true;
@@ -570,23 +737,75 @@ bool Board::ok_cell3 (Pos pos, Dir dir) const {
 }
 
 
-bool Board::ok_cell2 (Pos pos) const {
-  for (int i = -4; i <= 4; ++i)
-    for (int j = -4; j <= 4; ++j) {
-      Pos p = pos + Pos(i, j);
-      if (pos_ok(p) and cell(p).type == Wall) return false;
-    }
-  return true;
-}
+/**
+ * Cells where generator2 may start a wall: those at distance at least 4
+ * from the border with no wall in the 9x9 square centered at them.
+ * Keeps the number of walls in the square of each cell, and a Fenwick
+ * tree over the candidates to find the k-th one in row-major order.
+ */
+class Wall_candidates {
 
+  int r, c;
+  vector<int> near_; // Walls in the square of each cell, in row-major order.
+  vector<int> tree_;
+  int n_;
 
-vector<Pos> Board::candidate_cells () const {
-  vector<Pos> r;
-  for (int i = 4; i < rows() - 4; ++i)
-    for (int j = 4; j < cols() - 4; ++j)
-      if (ok_cell2(Pos(i, j))) r.push_back(Pos(i, j));
-  return r;
-}
+  bool inside (int i, int j) const {
+    return i >= 4 and i < r - 4 and j >= 4 and j < c - 4;
+  }
+
+  void add (int k, int d) {
+    n_ += d;
+    for (int x = k + 1; x <= r*c; x += x & -x) tree_[x] += d;
+  }
+
+public:
+
+  Wall_candidates (int rows, int cols)
+    : r(rows), c(cols), near_(r*c, 0), tree_(r*c + 1, 0), n_(0) {
+    for (int i = 0; i < r; ++i)
+      for (int j = 0; j < c; ++j)
+        if (inside(i, j)) add(i*c + j, 1);
+  }
+
+  /**
+   * Updates the candidates after a wall has been put (d = 1)
+   * or removed (d = -1) at p.
+   */
+  void wall (Pos p, int d) {
+    for (int i = max(0, p.i - 4); i <= min(r - 1, p.i + 4); ++i)
+      for (int j = max(0, p.j - 4); j <= min(c - 1, p.j + 4); ++j) {
+        int k = i*c + j;
+        bool was = near_[k] == 0;
+        near_[k] += d;
+        bool is = near_[k] == 0;
+        if (inside(i, j) and was != is) add(k, is ? 1 : -1);
+      }
+  }
+
+  /**
+   * Returns the number of candidates.
+   */
+  int size () const {
+    return n_;
+  }
+
+  /**
+   * Returns the k-th (from 0) candidate in row-major order.
+   */
+  Pos kth (int k) const {
+    int x = 0;
+    int step = 1;
+    while (2*step <= r*c) step *= 2;
+    for (; step > 0; step /= 2)
+      if (x + step <= r*c and tree_[x + step] <= k) {
+        x += step;
+        k -= tree_[x];
+      }
+    return Pos(x/c, x%c);
+  }
+
+};
 
 
 bool Board::connected () const {
@@ -621,61 +840,70 @@ void Board::generator2 (vector<int> param) {
   int r = rows();
   int c = cols();
 
-  initial(r, c);
+  while (true) {
+    initial(r, c);
+
+    Wall_candidates cand(r, c);
+    for (int i = 0; i < r; ++i)
+      for (int j = 0; j < c; ++j)
+        if (grid_[i][j].type == Wall) cand.wall(Pos(i, j), 1);
 
-  vector<Pos> vp;
-  while (vp = candidate_cells(), not vp.empty()) {
-    set<Pos> S;
-    Pos pos = vp[random(0, vp.size() - 1)];
-    S.insert(pos);
-    grid_[pos.i][pos.j].type = Wall;
-    Dir dir = Dir(2*random(0, 4));
-    int steps = 0;
-    while (++steps <= 15) {
-      vector<Dir> v;
-      if (ok_cell3(pos, dir)) v.push_back(dir);
-      if (ok_cell3(pos, left(dir))) v.push_back(left(dir));
-      if (ok_cell3(pos, right(dir))) v.push_back(right(dir));
-      if (v.empty()) break;
-
-      dir = v[random(0, v.size() - 1)];
-      pos += dir;
+    while (cand.size() > 0) {
+      set<Pos> S;
+      Pos pos = cand.kth(random(0, cand.size() - 1));
       S.insert(pos);
       grid_[pos.i][pos.j].type = Wall;
-    }
+      cand.wall(pos, 1);
+      Dir dir = Dir(2*random(0, 4));
+      int steps = 0;
+      while (++steps <= 15) {
+        vector<Dir> v;
+        if (ok_cell3(pos, dir)) v.push_back(dir);
+        if (ok_cell3(pos, left(dir))) v.push_back(left(dir));
+        if (ok_cell3(pos, right(dir))) v.push_back(right(dir));
+        if (v.empty()) break;
+
+        dir = v[random(0, v.size() - 1)];
+        pos += dir;
+        S.insert(pos);
+        grid_[pos.i][pos.j].type = Wall;
+        cand.wall(pos, 1);
+      }
 
-    for (Pos p : S) {
-      bool ok = true;
-      for (int i = -3; i <= 3; ++i)
-        for (int j = -3; j <= 3; ++j) {
-          Pos p2 = p + Pos(i, j);
-          if (pos_ok(p2) and cell(p2).type == Wall and S.find(p2) == S.end())
-            ok = false;
+      for (Pos p : S) {
+        bool ok = true;
+        for (int i = -3; i <= 3; ++i)
+          for (int j = -3; j <= 3; ++j) {
+            Pos p2 = p + Pos(i, j);
+            if (pos_ok(p2) and cell(p2).type == Wall and S.find(p2) == S.end())
+              ok = false;
+          }
+        _log_debug("wall " << p << ' ' << ok);
+        if (not ok) {
+          grid_[p.i][p.j].type = Empty;
+          cand.wall(p, -1);
         }
-      cerr << p << ' ' << ok << endl;
-      if (not ok) grid_[p.i][p.j].type = Empty;
+      }
     }
-  }
 
-  for (int i = 1; i < rows() - 3; ++i)
-    for (int j = 1; j < cols() - 3; ++j) {
-      int i2 = i + 1;
-      int j2 = j + 1;
-      if (cell(i, j).type == Wall and cell(i, j2).type == Empty
-          and cell(i2, j).type == Empty and cell(i2, j2).type == Wall) {
-        if (random(0, 1)) grid_[i][j2].type = Wall;
-        else grid_[i2][j].type = Wall;
-      }
-      if (cell(i, j).type == Empty and cell(i, j2).type == Wall
-          and cell(i2, j).type == Wall and cell(i2, j2).type == Empty) {
-        if (random(0, 1)) grid_[i][j].type = Wall;
-        else grid_[i2][j2].type = Wall;
+    for (int i = 1; i < rows() - 3; ++i)
+      for (int j = 1; j < cols() - 3; ++j) {
+        int i2 = i + 1;
+        int j2 = j + 1;
+        if (cell(i, j).type == Wall and cell(i, j2).type == Empty
+            and cell(i2, j).type == Empty and cell(i2, j2).type == Wall) {
+          if (random(0, 1)) grid_[i][j2].type = Wall;
+          else grid_[i2][j].type = Wall;
+        }
+        if (cell(i, j).type == Empty and cell(i, j2).type == Wall
+            and cell(i2, j).type == Wall and cell(i2, j2).type == Empty) {
+          if (random(0, 1)) grid_[i][j].type = Wall;
+          else grid_[i2][j2].type = Wall;
+        }
       }
-    }
 
-  if (not connected()) {
-    cerr << "warning: unconected board discarted" << endl;
-    generator2(param);
+    if (connected()) return;
+    _log_warning("unconected board discarted");
   }
 }
 
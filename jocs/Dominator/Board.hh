@@ -5,6 +5,9 @@
 #include "Info.hh"
 #include "Action.hh"
 #include "Random.hh"
+#include "Writer.hh"
+#include "Profile.hh"
+#include "GridCache.hh"
 
 
 /*! \file
@@ -13,6 +16,21 @@
  */
 
 
+/**
+ * A map as read from a stream: the settings, the grid generator and its
+ * parameters, and the grid itself if it is FIXED. Many games can be
+ * started from it without reading the stream again.
+ */
+struct Map {
+
+  Settings settings;
+  string generator;
+  vector<int> param;            // Parameters of the generator.
+  vector< vector<Cell> > grid;  // Only if the generator is FIXED.
+
+};
+
+
 /**
  * Manages a random generator and the information of the board.
  */
@@ -25,22 +43,71 @@ class Board : public Info, public Random_generator {
   string generator_;
 
   /**
-   * Reads the generator method, and generates or reads the grid.
+   * Where to measure the phases of next(), if not null. Set by Game.
+   */
+  Profile* prof_ = nullptr;
+
+  /**
+   * Number of active witches haunting each cell.
+   * A cell is haunted if and only if this number is positive.
+   */
+  vector< vector<int> > haunters_;
+
+  /**
+   * What surrounds a cell, as far as spawning units is concerned.
+   */
+  struct Near {
+    int witches;        // Witches at distance 3 or less.
+    int units;          // Units among the 8 neighbours,
+    int units_of[4];    // and those of each player.
+    int knights;        // Knights among the 4 orthogonal neighbours,
+    int knights_of[4];  // and those of each player.
+  };
+
+  /**
+   * Surroundings of each cell, kept up to date as units come, go and move,
+   * so that whether a unit can be spawned at a cell is known at once.
+   */
+  vector< vector<Near> > near_;
+
+  /**
+   * Copies the grid of the map, or generates it with the generator of the map.
    */
-  void read_generator_and_grid (istream& is) {
-    is >> generator_;
-    if (generator_ == "FIXED") read_grid(is);
+  void make_grid (const Map& m) {
+    generator_ = m.generator;
+    if (generator_ == "FIXED") grid_ = m.grid;
     else {
-      vector<int> param;
-      int x;
-      while (is >> x) param.push_back(x);
-      if (generator_ == "GENERATOR1") generator1(param);
-      else if (generator_ == "GENERATOR2") generator2(param);
-      else if (generator_ == "GENERATOR3") generator3(param);
+      string key = grid_key(m.param);
+      if (Grid_cache::enabled() and load_grid(key)) return;
+
+      if (generator_ == "GENERATOR1") generator1(m.param);
+      else if (generator_ == "GENERATOR2") generator2(m.param);
+      else if (generator_ == "GENERATOR3") generator3(m.param);
       else _my_assert(false, "Unknow grid generator.");
+
+      if (Grid_cache::enabled()) store_grid(key);
     }
   }
 
+  /**
+   * Returns what determines the grid built by the generator with param:
+   * the version, the generator, its parameters, the size of the board
+   * and the state of the random generator.
+   */
+  string grid_key (const vector<int>& param) const;
+
+  /**
+   * Reads the grid with the given key from the grid cache, together with
+   * the state the random generator had right after generating it.
+   * Returns false if the cache does not have it.
+   */
+  bool load_grid (const string& key);
+
+  /**
+   * Writes the grid to the grid cache with the given key.
+   */
+  void store_grid (const string& key) const;
+
   /**
    * Fills the board with empty cells and surrounding walls.
    */
@@ -69,8 +136,6 @@ class Board : public Info, public Random_generator {
   static Dir right (Dir d);
   bool empty_line (Pos pos, Dir dir) const;
   bool ok_cell3 (Pos pos, Dir dir) const;
-  bool ok_cell2 (Pos pos) const;
-  vector<Pos> candidate_cells () const;
   bool connected () const;
 
   /**
@@ -90,12 +155,12 @@ class Board : public Info, public Random_generator {
   /**
    * Prints some information of the unit.
    */
-  inline static void print_unit (Unit u, ostream& os) {
+  inline static void print_unit (Unit u, Writer& os) {
     os << ut2char(u.type) << ' '
        << u.player << ' '
        << u.pos.i << ' '
        << u.pos.j << ' '
-       << u.health << endl;
+       << u.health << '\n';
   }
 
   void capture (int id, int pl, vector<bool>& killed);
@@ -107,6 +172,30 @@ class Board : public Info, public Random_generator {
    */
   void spell (int id, vector<bool>& killed);
 
+  /**
+   * Adds d to the haunters of the cells at distance 2 or less of p,
+   * and appends those cells to touched.
+   */
+  void haunt (Pos p, int d, vector<Pos>& touched);
+
+  /**
+   * Returns whether the witch id has no other witch at distance 2 or less.
+   */
+  bool witch_active (int id) const;
+
+  /**
+   * Computes the active witches, the haunters and the haunted cells
+   * from scratch.
+   */
+  void init_haunted ();
+
+  /**
+   * Moves the witch id to the empty cell p2. Only the witches close to
+   * its old or new position can change, so only their cells are updated.
+   * Casts spells on the units in the cells that become haunted.
+   */
+  void move_witch (int id, Pos p2, vector<bool>& killed);
+
   /**
    * Tries to apply a move. Returns true if it could. Marks killed units.
    */
@@ -123,8 +212,30 @@ class Board : public Info, public Random_generator {
   bool available (int i, int j) const;
   int witch_team (Pos pos) const;
   bool pos_witch_ok (int i, int j) const;
-  bool ok_cell (int pl, Pos pos, bool knight) const;
   void place (int id, Pos p);
+
+  /**
+   * Computes the surroundings of the cells for a board with no units.
+   */
+  void init_near ();
+
+  /**
+   * Adds d to the surroundings of the cells around p for the unit id,
+   * which has arrived at (d = 1) or left (d = -1) p.
+   */
+  void presence (int id, Pos p, int d);
+
+  /**
+   * Returns whether a knight (or a farmer) of pl can be spawned at p:
+   * p is available, there is no witch at distance 3 or less and,
+   * for a knight, no unit of another player among the 8 neighbours,
+   * or, for a farmer, no knight of another player among the 4 orthogonal ones.
+   */
+  bool spawnable (int pl, Pos p, bool knight) const;
+
+  /**
+   * Places the units of uni from ini on at random positions of pos.
+   */
   void spawn (const vector<Pos>& pos, const vector<int>& uni, int ini);
 
   /**
@@ -151,10 +262,20 @@ class Board : public Info, public Random_generator {
 
 public:
 
+  /**
+   * Reads a map from a stream.
+   */
+  static Map read_map (istream& is);
+
+  /**
+   * Construct a board for a game with the given seed on a map.
+   */
+  Board (const Map& m, int seed);
+
   /**
    * Construct a board by reading information from a stream.
    */
-  Board (istream& is, int seed);
+  Board (istream& is, int seed) : Board(read_map(is), seed) { }
 
   /**
    * Returns the name of a player.
@@ -175,9 +296,9 @@ public:
   void print_names (ostream& os) const;
 
   /**
-   * Prints the state of the board to a stream.
+   * Prints the state of the board to a writer.
    */
-  void print_state (ostream& os) const;
+  void print_state (Writer& os) const;
 
   /**
    * Prints the results and the names of the winning players.
@@ -1,12 +1,14 @@
 #include "Game.hh"
 
 
-void Game::run (vector<string> names, istream& is, ostream& os, int seed) {
-  cerr << "info: seed " << seed << endl;
+Board Game::play (const vector<string>& names, const Map& m, ostream& os, int seed,
+                  Profile* prof) {
+  _log_info("seed " << seed);
 
-  cerr << "info: loading game" << endl;
-  Board b(is, seed);
-  cerr << "info: loaded game" << endl;
+  _log_info("loading game");
+  Board b(m, seed);
+  b.prof_ = prof;
+  _log_info("loaded game");
 
   int np = b.nb_players();
   int nr = b.nb_rounds();
@@ -17,37 +19,73 @@ void Game::run (vector<string> names, istream& is, ostream& os, int seed) {
   for (int pl = 0; pl < np; ++pl) {
     string name = names[pl];
     b.names_[pl] = name;
-    cerr << "info: loading player " << name << endl;
+    _log_info("loading player " << name);
     players.push_back(Registry::new_player(name));
     players[pl]->me_ = pl;
     players[pl]->set_random_seed(seed + pl + 1);
     *static_cast<Settings*>(players[pl]) = (Settings)b;
   }
-  cerr << "info: players loaded" << endl;
+  _log_info("players loaded");
 
-  os << "Game" << endl << endl;
-  os << "Seed " << seed << endl << endl;
-  b.print_preamble(os);
-  b.print_names(os);
-  b.print_state(os);
+  // Each round is formatted into w and written to os in one go.
+  Writer w;
+  w << "Game" << endl << endl;
+  w << "Seed " << seed << endl << endl;
+  b.print_preamble(w);
+  b.print_names(w);
+  b.print_state(w);
+  w.write_to(os);
 
   for (int round = 0; round < nr; ++round) {
-    cerr << "info: start round " << round << endl;
+    _log_info("start round " << round);
+    if (prof) prof->set_round(round);
     vector<Action> actions(np);
     for (int pl = 0; pl < np; ++pl) {
-      cerr << "info:     start player " << pl << endl;
+      _log_info("    start player " << pl);
+      Log::flush(); // the player may write to stderr too
       players[pl]->reset(b);
-      players[pl]->play();
+      {
+        Profile::Timer timer(prof, Profile::Play, pl);
+        players[pl]->play();
+      }
       actions[pl] = *players[pl];
-      cerr << "info:     end player " << pl << endl;
+      _log_info("    end player " << pl);
     }
 
-    b.next(actions, os);
-    b.print_state(os);
-    cerr << "info: end round " << round << endl;
+    {
+      Profile::Timer timer(prof, Profile::Next);
+      b.next(actions, w);
+    }
+    {
+      Profile::Timer timer(prof, Profile::Print);
+      b.print_state(w);
+      w.write_to(os);
+    }
+    _log_info("end round " << round);
   }
 
+  // Player has no virtual destructor (the AIDummy objects are compiled
+  // against its layout), so each AI is deleted by the function it registered.
+  for (int pl = 0; pl < np; ++pl) Registry::delete_player(names[pl], players[pl]);
+
+  b.prof_ = nullptr;
+  return b;
+}
+
+
+Board Game::play (const vector<string>& names, istream& is, ostream& os, int seed,
+                  Profile* prof) {
+  return play(names, Board::read_map(is), os, seed, prof);
+}
+
+
+void Game::run (vector<string> names, istream& is, ostream& os, int seed,
+                Profile* prof) {
+  Board b = play(names, is, os, seed, prof);
+
+  // Results are always printed, after any pending log messages.
+  Log::flush();
   b.print_results();
 
-  cerr << "info: game played" << endl;
+  _log_info("game played");
 }
@@ -13,7 +13,26 @@ class Game {
 
 public:
 
-  static void run (vector<string> names, istream& is, ostream& os, int seed);
+  /**
+   * Plays a whole game, writing it to os, and returns the final board.
+   * Everything it uses belongs to the game, so several games can be
+   * played at the same time in different threads.
+   * If prof is not null, the phases of the game are measured there.
+   */
+  static Board play (const vector<string>& names, const Map& m, ostream& os, int seed,
+                     Profile* prof = nullptr);
+
+  /**
+   * Plays a whole game on the map read from is, as the function above.
+   */
+  static Board play (const vector<string>& names, istream& is, ostream& os, int seed,
+                     Profile* prof = nullptr);
+
+  /**
+   * Plays a whole game, writing it to os, and prints the results.
+   */
+  static void run (vector<string> names, istream& is, ostream& os, int seed,
+                   Profile* prof = nullptr);
 
 };
 
@@ -7,7 +7,11 @@ void help (int argc, char** argv) {
   cout << "--seed=seed     -s seed     set random seed"                   << endl;
   cout << "--input=file    -i input    set input file  (default: stdin)"  << endl;
   cout << "--output=file   -o output   set output file (default: stdout)" << endl;
+  cout << "--profile=file  -p file     write time spent per phase and player (JSON)" << endl;
+  cout << "--trace=file    -t file     write every measured phase (Chrome trace)" << endl;
+  cout << "--grids=dir     -g dir      keep generated grids in dir, to reuse them" << endl;
   cout << "--list          -l          list registered players"           << endl;
+  cout << "--quiet         -q          only log warnings and errors"      << endl;
   cout << "--version       -v          print version"                     << endl;
   cout << "--help          -h          print help"                        << endl;
 }
@@ -23,7 +27,11 @@ int main (int argc, char** argv) {
     { "seed",    required_argument, 0, 's' },
     { "input",   required_argument, 0, 'i' },
     { "output",  required_argument, 0, 'o' },
+    { "profile", required_argument, 0, 'p' },
+    { "trace",   required_argument, 0, 't' },
+    { "grids",   required_argument, 0, 'g' },
     { "list",    no_argument,       0, 'l' },
+    { "quiet",   no_argument,       0, 'q' },
     { "version", no_argument,       0, 'v' },
     { "help",    no_argument,       0, 'h' },
     { 0, 0, 0, 0 }
@@ -31,12 +39,14 @@ int main (int argc, char** argv) {
 
   char* ifile = 0;
   char* ofile = 0;
+  char* pfile = 0;
+  char* tfile = 0;
   int seed = -1;
   vector<string> names;
 
   while (true) {
     int index = 0;
-    int c = getopt_long(argc, argv, "s:i:o:lvh", long_options, &index);
+    int c = getopt_long(argc, argv, "s:i:o:p:t:g:lqvh", long_options, &index);
     if (c == -1) break;
 
     switch (c) {
@@ -49,9 +59,21 @@ int main (int argc, char** argv) {
       case 'o':
         ofile = optarg;
         break;
+      case 'p':
+        pfile = optarg;
+        break;
+      case 't':
+        tfile = optarg;
+        break;
+      case 'g':
+        Grid_cache::set_dir(optarg);
+        break;
       case 'l':
         Registry::print_players(cout);
         return EXIT_SUCCESS;
+      case 'q':
+        Log::set_level(LOG_WARNING);
+        break;
       case 'v':
         cout << Board::version() << endl;
         cout << "compiled " << __TIME__ << " " << __DATE__ << endl;
@@ -83,7 +105,19 @@ int main (int argc, char** argv) {
   istream* is = ifile ? new ifstream(ifile) : &cin;
   ostream* os = ofile ? new ofstream(ofile) : &cout;
 
-  Game::run(names, *is, *os, seed);
+  Profile* prof = (pfile or tfile) ? new Profile(names, tfile != 0) : 0;
+
+  Game::run(names, *is, *os, seed, prof);
+
+  if (pfile) {
+    ofstream ofs(pfile);
+    prof->write_json(ofs);
+  }
+  if (tfile) {
+    ofstream ofs(tfile);
+    prof->write_trace(ofs);
+  }
+  delete prof;
 
   if (ifile) delete is;
   if (ofile) delete os;
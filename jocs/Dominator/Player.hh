@@ -26,7 +26,7 @@ class Player : public Info, public Random_generator, public Action {
 
   inline void reset (const Info& info) {
     *static_cast<Action*>(this) = Action();
-    *static_cast<State*>(this) = ((State)info).rotate(me_);
+    static_cast<const State&>(info).rotate_into(me_, *this);
   }
 
   void reset (ifstream& is);
@@ -0,0 +1,64 @@
+#include "Profile.hh"
+
+
+Profile::Profile (const vector<string>& names, bool trace)
+  : names_(names), stats_(NB_PHASES, vector<Stats>(1)),
+    trace_(trace), origin_(Clock::now()), round_(0) {
+  stats_[Play] = vector<Stats>(names.size());
+}
+
+
+const char* Profile::phase_name (Phase phase) {
+  switch (phase) {
+    case Play:  return "play";
+    case Next:  return "next";
+    case Spawn: return "spawn";
+    case Print: return "print";
+    default:    return "?";
+  }
+}
+
+
+static void print_stats (const Profile::Stats& s, ostream& os) {
+  os << "\"calls\": " << s.calls
+     << ", \"total_us\": " << s.total_ns/1000
+     << ", \"max_us\": " << s.max_ns/1000;
+}
+
+
+void Profile::write_json (ostream& os) const {
+  os << "{" << endl;
+  os << "  \"players\": [" << endl;
+  for (int pl = 0; pl < (int)names_.size(); ++pl) {
+    os << "    { \"player\": " << pl << ", \"name\": \"" << names_[pl] << "\", ";
+    print_stats(stats(Play, pl), os);
+    os << " }" << (pl + 1 < (int)names_.size() ? "," : "") << endl;
+  }
+  os << "  ]," << endl;
+  os << "  \"phases\": {" << endl;
+  for (int ph = Next; ph < NB_PHASES; ++ph) {
+    os << "    \"" << phase_name(Phase(ph)) << "\": { ";
+    print_stats(stats(Phase(ph)), os);
+    os << " }" << (ph + 1 < NB_PHASES ? "," : "") << endl;
+  }
+  os << "  }" << endl;
+  os << "}" << endl;
+}
+
+
+void Profile::write_trace (ostream& os) const {
+  os << "{\"traceEvents\": [" << endl;
+  for (int pl = 0; pl < (int)names_.size(); ++pl)
+    os << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << pl + 1
+       << ", \"args\": {\"name\": \"" << names_[pl] << "\"}}," << endl;
+  os << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": 0"
+     << ", \"args\": {\"name\": \"board\"}}";
+  for (const Event& e : events_)
+    os << "," << endl
+       << "{\"name\": \"" << phase_name(e.phase) << "\", \"ph\": \"X\", \"pid\": 0"
+       << ", \"tid\": " << (e.phase == Play ? e.player + 1 : 0)
+       << ", \"ts\": " << e.start_ns/1000 << "." << setw(3) << setfill('0') << e.start_ns%1000
+       << ", \"dur\": " << e.dur_ns/1000 << "." << setw(3) << setfill('0') << e.dur_ns%1000
+       << setfill(' ') << ", \"args\": {\"round\": " << e.round << "}}";
+  os << endl << "]}" << endl;
+}
@@ -0,0 +1,136 @@
+#ifndef Profile_hh
+#define Profile_hh
+
+
+#include "Utils.hh"
+
+#include <chrono>
+
+
+/*! \file
+ * Contains the Profile class, which measures where the time of a game goes.
+ */
+
+
+/**
+ * Time spent by a game in each phase, and by each player in play().
+ *
+ * Phases are measured with scoped timers on a monotonic clock. A timer
+ * given a null profile does nothing, so games that are not profiled
+ * do not even read the clock.
+ */
+class Profile {
+
+public:
+
+  /**
+   * Measured phases. Spawn happens inside Next.
+   */
+  enum Phase { Play, Next, Spawn, Print, NB_PHASES };
+
+  typedef std::chrono::steady_clock Clock;
+
+  /**
+   * Accumulated measures of a phase (of a player, for Play).
+   */
+  struct Stats {
+    long long calls = 0;
+    long long total_ns = 0;
+    long long max_ns = 0;
+  };
+
+  /**
+   * Measures the time from its construction to its destruction.
+   */
+  class Timer {
+    Profile* prof_;
+    Phase phase_;
+    int player_;
+    Clock::time_point start_;
+  public:
+    Timer (Profile* prof, Phase phase, int player = 0)
+      : prof_(prof), phase_(phase), player_(player) {
+      if (prof_) start_ = Clock::now();
+    }
+    ~Timer () {
+      if (prof_) prof_->add(phase_, player_, start_, Clock::now());
+    }
+  };
+
+private:
+
+  /**
+   * A measure kept for the trace.
+   */
+  struct Event {
+    Phase phase;
+    int player;
+    int round;
+    long long start_ns;
+    long long dur_ns;
+  };
+
+  vector<string> names_;
+  vector< vector<Stats> > stats_; // Per phase; per player for Play.
+  bool trace_;
+  vector<Event> events_;
+  Clock::time_point origin_;
+  int round_;
+
+public:
+
+  /**
+   * Prepares a profile for a game with these players.
+   * Only keeps every single measure (for write_trace) if trace is set.
+   */
+  Profile (const vector<string>& names, bool trace);
+
+  /**
+   * Sets the round being played, used to label the trace.
+   */
+  inline void set_round (int round) {
+    round_ = round;
+  }
+
+  /**
+   * Adds a measure of a phase.
+   */
+  inline void add (Phase phase, int player, Clock::time_point start, Clock::time_point end) {
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    Stats& s = stats_[phase][phase == Play ? player : 0];
+    ++s.calls;
+    s.total_ns += ns;
+    s.max_ns = max(s.max_ns, ns);
+    if (trace_) {
+      long long from = std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin_).count();
+      events_.push_back({phase, player, round_, from, ns});
+    }
+  }
+
+  /**
+   * Returns the accumulated measures of a phase (of a player, for Play).
+   */
+  inline const Stats& stats (Phase phase, int player = 0) const {
+    return stats_[phase][phase == Play ? player : 0];
+  }
+
+  /**
+   * Returns the name of a phase.
+   */
+  static const char* phase_name (Phase phase);
+
+  /**
+   * Writes the accumulated measures as JSON.
+   */
+  void write_json (ostream& os) const;
+
+  /**
+   * Writes every measure in the Chrome trace event format
+   * (to be opened with chrome://tracing or Perfetto).
+   */
+  void write_trace (ostream& os) const;
+
+};
+
+
+#endif
@@ -1,26 +1,44 @@
 #include "Registry.hh"
 
 
-typedef map<string, Registry::Factory> dict_;
+typedef map<string, pair<Registry::Factory, Registry::Deleter> > dict_;
 
 
-dict_* reg_ = 0;
+// Built on first use, so that players registered during static
+// initialization find it ready whatever the order of the objects.
+static dict_& registry () {
+  static dict_ reg;
+  return reg;
+}
 
 
 int Registry::Register (const char* name, Factory factory) {
-  if (reg_ == 0) reg_ = new dict_();
-  (*reg_)[name] = factory;
+  return Register(name, factory, nullptr);
+}
+
+
+int Registry::Register (const char* name, Factory factory, Deleter del) {
+  registry()[name] = make_pair(factory, del);
   return 999;
 }
 
 
 Player* Registry::new_player (string name) {
-  auto it = reg_->find(name);
-  _my_assert(it != reg_->end(), "Player " + name + " not registered.");
-  return (it->second)();
+  const dict_& reg = registry();
+  auto it = reg.find(name);
+  _my_assert(it != reg.end(), "Player " + name + " not registered.");
+  return (it->second.first)();
+}
+
+
+void Registry::delete_player (string name, Player* p) {
+  const dict_& reg = registry();
+  auto it = reg.find(name);
+  _my_assert(it != reg.end(), "Player " + name + " not registered.");
+  if (it->second.second) (it->second.second)(p);
 }
 
 
 void Registry::print_players (ostream& os) {
-  for (const auto& it : *reg_) cout << it.first << endl;
+  for (const auto& it : registry()) os << it.first << endl;
 }
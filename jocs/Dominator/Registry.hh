@@ -16,25 +16,52 @@ class Player;
 /**
  * Since the main program does not know how many players will be inherited
  * from the Player class, we use a registration and factory pattern.
+ *
+ * Players register themselves during static initialization, before main.
+ * After that the registry is only read, so new_player can be called
+ * from several threads at the same time.
  */
 class Registry {
 
 public:
 
   typedef Player* (*Factory)();
+  typedef void (*Deleter)(Player*);
 
+  /**
+   * Registers a player that cannot be deleted (the prebuilt AIDummy
+   * objects, compiled before deleters existed). It is never freed.
+   */
   static int Register (const char* name, Factory fact);
 
+  /**
+   * Registers a player with the function that deletes it as what it is,
+   * since Player has no virtual destructor.
+   */
+  static int Register (const char* name, Factory fact, Deleter del);
+
   static Player* new_player (string name);
 
+  /**
+   * Deletes a player created by new_player(name).
+   */
+  static void delete_player (string name, Player* p);
+
   static void print_players (ostream& os);
 
 };
 
 
 #define _stringification(s) #s
+// The deleter destroys the player as an x, which is what x::factory created
+// (a plain delete would warn, since Player has no virtual destructor).
 #define RegisterPlayer(x) static int registration = \
-        Registry::Register(_stringification(x), x::factory)
+        Registry::Register(_stringification(x), x::factory, \
+                           [] (Player* p) {                     \
+                             x* q = static_cast<x*>(p);         \
+                             q->~x();                           \
+                             ::operator delete(q);              \
+                           })
 
 
 #endif
@@ -224,15 +224,30 @@ public:
   }
 
   /**
-   * Returns the state rotated for player pl.
+   * Writes into res the state rotated for player pl.
+   * The memory of res is reused, so that nothing is allocated
+   * when res already holds a state of the same game.
    */
-  State rotate (int pl) const {
-    State res = *this;
+  void rotate_into (int pl, State& res) const {
+    if (pl == 0) {
+      res = *this;
+      return;
+    }
 
-    if (pl == 0) return res;
+    res.round_ = round_;
+    res.unit_ = unit_;
 
+    int n = grid_.size();
+    res.grid_.resize(n);
+    for (int i = 0; i < n; ++i) res.grid_[i].resize(grid_[i].size());
     rotate(res.grid_, res.unit_, pl);
 
+    res.land_.resize(4);
+    res.total_score_.resize(4);
+    res.cpu_status_.resize(4);
+    res.farmers_.resize(4);
+    res.knights_.resize(4);
+    res.witches_.resize(4);
     for (int i = 0; i < 4; ++i) {
       int j = (i + pl)%4;
       res.land_[i] = land_[j];
@@ -242,7 +257,14 @@ public:
       res.knights_[i] = knights_[j];
       res.witches_[i] = witches_[j];
     }
+  }
 
+  /**
+   * Returns the state rotated for player pl.
+   */
+  State rotate (int pl) const {
+    State res;
+    rotate_into(pl, res);
     return res;
   }
 
@@ -0,0 +1,131 @@
+#include "Tournament.hh"
+
+#include <thread>
+
+
+void help (int argc, char** argv) {
+  cout << "Usage: " << argv[0] << " [options] player1 player2 player3 player4 ... " << endl;
+  cout << "Plays a game for every group of 4 players, map and seed." << endl;
+  cout << "Available options:" << endl;
+  cout << "--map=file      -m file     add a map (default: default.cnf)"   << endl;
+  cout << "--seeds=a-b     -s a-b      set the range of seeds (default: 1-10)" << endl;
+  cout << "--threads=n     -j n        set number of threads (default: all cores)" << endl;
+  cout << "--grids=dir     -g dir      keep generated grids in dir, to reuse them" << endl;
+  cout << "--check         -c          replay all games alone and compare" << endl;
+  cout << "--list          -l          list registered players"           << endl;
+  cout << "--verbose       -V          also log info messages"            << endl;
+  cout << "--version       -v          print version"                     << endl;
+  cout << "--help          -h          print help"                        << endl;
+}
+
+
+/**
+ * Reads a whole string as an integer. Returns false if it is not one.
+ */
+bool read_int (const string& s, int& x) {
+  istringstream iss(s);
+  return (iss >> x) and iss.eof();
+}
+
+
+int main (int argc, char** argv) {
+  if (argc == 1) {
+    help(argc, argv);
+    return EXIT_SUCCESS;
+  }
+
+  struct option long_options[] = {
+    { "map",     required_argument, 0, 'm' },
+    { "seeds",   required_argument, 0, 's' },
+    { "threads", required_argument, 0, 'j' },
+    { "grids",   required_argument, 0, 'g' },
+    { "check",   no_argument,       0, 'c' },
+    { "list",    no_argument,       0, 'l' },
+    { "verbose", no_argument,       0, 'V' },
+    { "version", no_argument,       0, 'v' },
+    { "help",    no_argument,       0, 'h' },
+    { 0, 0, 0, 0 }
+  };
+
+  vector<string> maps;
+  int first_seed = 1;
+  int last_seed = 10;
+  int threads = max(1, int(thread::hardware_concurrency()));
+  bool check = false;
+  vector<string> names;
+
+  // Games of different threads would interleave their messages.
+  Log::set_level(LOG_WARNING);
+
+  while (true) {
+    int index = 0;
+    int c = getopt_long(argc, argv, "m:s:j:g:clVvh", long_options, &index);
+    if (c == -1) break;
+
+    switch (c) {
+      case 'm':
+        maps.push_back(optarg);
+        break;
+      case 's': {
+        string s = optarg;
+        size_t dash = s.find('-');
+        bool ok = read_int(s.substr(0, dash), first_seed);
+        if (dash == string::npos) last_seed = first_seed;
+        else ok = ok and read_int(s.substr(dash + 1), last_seed);
+        if (not ok or first_seed < 0 or last_seed < first_seed) {
+          _log_error("wrong range of seeds " << optarg);
+          help(argc, argv);
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+      case 'j':
+        if (not read_int(optarg, threads) or threads < 1) {
+          _log_error("wrong number of threads " << optarg);
+          help(argc, argv);
+          return EXIT_FAILURE;
+        }
+        break;
+      case 'g':
+        Grid_cache::set_dir(optarg);
+        break;
+      case 'c':
+        check = true;
+        break;
+      case 'l':
+        Registry::print_players(cout);
+        return EXIT_SUCCESS;
+      case 'V':
+        Log::set_level(LOG_DEBUG);
+        break;
+      case 'v':
+        cout << Board::version() << endl;
+        cout << "compiled " << __TIME__ << " " << __DATE__ << endl;
+        return EXIT_SUCCESS;
+      case 'h':
+        help(argc, argv);
+        return EXIT_SUCCESS;
+      default:
+        return EXIT_FAILURE;
+    }
+  }
+
+  while (optind < argc) {
+    names.push_back(argv[optind++]);
+    _my_assert(names.back().size() <= 12, "Player name too long.");
+  }
+
+  if (maps.empty()) maps.push_back("default.cnf");
+
+  Tournament t(names, maps, first_seed, last_seed);
+  _log_info("playing " << t.nb_matches() << " games with " << threads << " threads");
+  t.play(threads);
+  Tournament::print_standings(t.standings(), cout);
+
+  if (check) {
+    int wrong = t.check();
+    if (wrong) _log_error(wrong << " of " << t.nb_matches() << " games differ when played alone");
+    else _log_info("all " << t.nb_matches() << " games are the same when played alone");
+    if (wrong) return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,165 @@
+#include "Tournament.hh"
+
+#include <atomic>
+#include <thread>
+
+
+/**
+ * Stream buffer that only computes a hash (64-bit FNV-1a) of what it gets.
+ */
+class Digest : public streambuf {
+public:
+  unsigned long long hash = 14695981039346656037ull;
+protected:
+  int_type overflow (int_type c) {
+    if (c != traits_type::eof()) add(char(c));
+    return c;
+  }
+  streamsize xsputn (const char* s, streamsize n) {
+    for (streamsize i = 0; i < n; ++i) add(s[i]);
+    return n;
+  }
+private:
+  void add (char c) {
+    hash = (hash ^ (unsigned char)c)*1099511628211ull;
+  }
+};
+
+
+Tournament::Tournament (const vector<string>& names,
+                        const vector<string>& map_files,
+                        int first_seed, int last_seed)
+  : names_(names) {
+
+  _my_assert(names_.size() >= 4, "At least 4 participants are needed.");
+  _my_assert(first_seed >= 0 and first_seed <= last_seed, "Wrong seed range.");
+
+  for (const string& file : map_files) {
+    ifstream ifs(file);
+    _my_assert(ifs.good(), "Cannot open map " + file + ".");
+    maps_.push_back(Board::read_map(ifs));
+  }
+
+  // All groups of 4 participants, in lexicographic order.
+  int n = names_.size();
+  vector< vector<int> > groups;
+  for (int a = 0; a < n; ++a)
+    for (int b = a + 1; b < n; ++b)
+      for (int c = b + 1; c < n; ++c)
+        for (int d = c + 1; d < n; ++d)
+          groups.push_back({a, b, c, d});
+
+  for (const auto& g : groups)
+    for (int m = 0; m < (int)maps_.size(); ++m)
+      for (int seed = first_seed; seed <= last_seed; ++seed) {
+        Match match;
+        match.map = m;
+        match.seed = seed;
+        for (int pl = 0; pl < 4; ++pl) match.seats.push_back(g[(pl + seed)%4]);
+        matches_.push_back(match);
+      }
+
+  result_ = vector<Result>(matches_.size());
+}
+
+
+Result Tournament::play_match (int k) const {
+  const Match& m = matches_[k];
+
+  vector<string> names;
+  for (int id : m.seats) names.push_back(names_[id]);
+
+  Digest digest;
+  ostream os(&digest);
+  Board b = Game::play(names, maps_[m.map], os, m.seed);
+
+  Result r;
+  for (int pl = 0; pl < b.nb_players(); ++pl)
+    r.score.push_back(b.total_score(pl));
+  r.digest = digest.hash;
+  return r;
+}
+
+
+void Tournament::play (int nb_threads) {
+  atomic<int> next(0);
+  auto worker = [&] () {
+    for (int k = next++; k < nb_matches(); k = next++) result_[k] = play_match(k);
+  };
+
+  vector<thread> threads;
+  for (int t = 1; t < nb_threads; ++t) threads.push_back(thread(worker));
+  worker();
+  for (thread& t : threads) t.join();
+}
+
+
+int Tournament::check () const {
+  int wrong = 0;
+  for (int k = 0; k < nb_matches(); ++k)
+    if (not (play_match(k) == result_[k])) {
+      const Match& m = matches_[k];
+      _log_error("game " << k << " (map " << m.map << ", seed " << m.seed
+                 << ") differs when played alone");
+      ++wrong;
+    }
+  return wrong;
+}
+
+
+vector<Standing> Tournament::standings () const {
+  int n = names_.size();
+  vector<Standing> st(n);
+  for (int id = 0; id < n; ++id) {
+    st[id].name = names_[id];
+    st[id].games = st[id].wins = 0;
+    st[id].score = 0;
+    st[id].elo = INITIAL_ELO;
+  }
+
+  for (int k = 0; k < nb_matches(); ++k) {
+    const vector<int>& seats = matches_[k].seats;
+    const vector<int>& score = result_[k].score;
+    int np = seats.size();
+
+    int top = *max_element(score.begin(), score.end());
+    vector<double> delta(np, 0);
+    for (int a = 0; a < np; ++a) {
+      Standing& s = st[seats[a]];
+      ++s.games;
+      s.score += score[a];
+      if (score[a] == top) ++s.wins;
+
+      for (int b = 0; b < np; ++b)
+        if (b != a) {
+          double expected =
+            1/(1 + pow(10, (st[seats[b]].elo - st[seats[a]].elo)/400));
+          double result = score[a] > score[b] ? 1 : score[a] == score[b] ? 0.5 : 0;
+          delta[a] += ELO_K/(np - 1)*(result - expected);
+        }
+    }
+    for (int a = 0; a < np; ++a) st[seats[a]].elo += delta[a];
+  }
+
+  stable_sort(st.begin(), st.end(), [] (const Standing& x, const Standing& y) {
+    return x.elo > y.elo;
+  });
+  return st;
+}
+
+
+void Tournament::print_standings (const vector<Standing>& st, ostream& os) {
+  os << "rank  player         games   wins        score     mean     elo" << endl;
+  for (int r = 0; r < (int)st.size(); ++r) {
+    const Standing& s = st[r];
+    double mean = s.games ? double(s.score)/s.games : 0;
+    os << setw(4) << r + 1 << "  "
+       << left << setw(12) << s.name << right
+       << setw(8) << s.games
+       << setw(7) << s.wins
+       << setw(13) << s.score
+       << fixed << setprecision(1)
+       << setw(9) << mean
+       << setw(8) << s.elo << endl;
+  }
+}
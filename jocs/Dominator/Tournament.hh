@@ -0,0 +1,124 @@
+#ifndef Tournament_hh
+#define Tournament_hh
+
+
+#include "Game.hh"
+
+
+/*! \file
+ * Contains the Tournament class, which plays many games in parallel
+ * and ranks the players that took part in them.
+ */
+
+
+/**
+ * A game of the tournament.
+ */
+struct Match {
+
+  vector<int> seats; // Participant sitting at each player position.
+  int map;           // Index of the map.
+  int seed;
+
+};
+
+
+/**
+ * Outcome of a match.
+ */
+struct Result {
+
+  vector<int> score;         // Final total score of each seat.
+  unsigned long long digest; // Hash of the whole game as written by Game::play.
+
+  friend bool operator== (const Result& a, const Result& b) {
+    return a.score == b.score and a.digest == b.digest;
+  }
+
+};
+
+
+/**
+ * Accumulated results of a participant.
+ */
+struct Standing {
+
+  string name;
+  int games;
+  int wins;        // Games where it got the top score, alone or tied.
+  long long score; // Sum of its final total scores.
+  double elo;
+
+};
+
+
+/**
+ * Plays a game for every group of 4 participants, every map and every seed,
+ * using several threads, and ranks the participants.
+ */
+class Tournament {
+
+  vector<string> names_;        // Participants.
+  vector<Map> maps_;            // Maps, read once for all the matches.
+  vector<Match> matches_;
+  vector<Result> result_;
+
+  /**
+   * Plays the match k and returns its outcome.
+   * Only reads the tournament, so several threads can call it at once.
+   */
+  Result play_match (int k) const;
+
+public:
+
+  /**
+   * Initial Elo rating and Elo K-factor.
+   */
+  static constexpr double INITIAL_ELO = 1500;
+  static constexpr double ELO_K = 32;
+
+  /**
+   * Reads the maps and prepares the matches. Seats are rotated with the
+   * seed, so that every participant plays from every corner.
+   */
+  Tournament (const vector<string>& names, const vector<string>& map_files,
+              int first_seed, int last_seed);
+
+  /**
+   * Returns the number of matches.
+   */
+  inline int nb_matches () const {
+    return matches_.size();
+  }
+
+  /**
+   * Plays all the matches using nb_threads threads. Each thread takes
+   * the next match not yet started, so that all of them stay busy
+   * however long each match lasts.
+   */
+  void play (int nb_threads);
+
+  /**
+   * Plays all the matches again, one after the other in this thread,
+   * and returns the number of them whose outcome differs from the one
+   * obtained by play(). Any difference means that some player or part
+   * of the game is not isolated within its own match.
+   */
+  int check () const;
+
+  /**
+   * Returns the standings, best Elo rating first. Elo ratings are updated
+   * match by match, in order, considering each match as a set of duels
+   * between every two of its players.
+   */
+  vector<Standing> standings () const;
+
+  /**
+   * Prints the standings to a stream.
+   */
+  static void print_standings (const vector<Standing>& st, ostream& os);
+
+};
+
+
+#endif
@@ -21,6 +21,8 @@
 #include <algorithm>
 #include <cmath>
 
+#include "Log.hh"
+
 using namespace std;
 
 
@@ -32,7 +34,7 @@ using namespace std;
 /**
  * Assert with message.
  */
-#define _my_assert(b, s) { if (not (b)) { cerr << "ERROR: " << s << endl; assert(b); } }
+#define _my_assert(b, s) { if (not (b)) { Log::flush(); cerr << "ERROR: " << s << endl; assert(b); } }
 
 
 /**
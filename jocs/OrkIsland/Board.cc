@@ -33,7 +33,10 @@ Board::Board (istream& is, int seed) {
 
   city_owner_ = vector<int>(city_.size(), -1);
   path_owner_ = vector<int>(path_.size(), -1);
+  init_scores();
+  init_coast();
   generate_units();
+  touched_.clear();
   _my_assert(ok(), "Invariants are not satisfied.");
 }
 
@@ -65,22 +68,22 @@ void Board::print_names (ostream& os) const {
 }
 
 
-void Board::print_state (ostream& os) const {
+void Board::print_state (Writer& os) const {
 
   // Should start with the same format of Info::read_grid.
   // Then other data describing the state.
 
-  os << endl << endl;
+  os << "\n\n";
 
   os << "   ";
   for (int j = 0; j < cols(); ++j)
     os << j / 10;
-  os << endl;
+  os << '\n';
 
   os << "   ";
   for (int j = 0; j < cols(); ++j)
     os << j % 10;
-  os << endl;
+  os << '\n';
 
   for (int i = 0; i < rows(); ++i) {
     os << i / 10 << i % 10 << " ";
@@ -88,57 +91,57 @@ void Board::print_state (ostream& os) const {
       const Cell& c = grid_[i][j];
       os << CellType2char(c.type);
     }
-    os << endl;
+    os << '\n';
   }
 
-  os << endl;
-  os << "cities " << city_.size() << endl;
+  os << '\n';
+  os << "cities " << city_.size() << '\n';
   for (int k = 0; k < int(city_.size()); ++k) {
-    os << endl << city_[k].size() << endl;
+    os << '\n' << city_[k].size() << '\n';
     for (auto x: city_[k]) {
-      os << x.i << " " << x.j << endl;
+      os << x.i << " " << x.j << '\n';
     }
   }
 
-  os << endl;
-  os << "paths " << path_.size() << endl;
+  os << '\n';
+  os << "paths " << path_.size() << '\n';
   for (int k = 0; k < int(path_.size()); ++k) {
-    os << endl
+    os << '\n'
        << path_[k].first.first << " " << path_[k].first.second << " "
-       << path_[k].second.size() << endl;
+       << path_[k].second.size() << '\n';
     for (auto x: path_[k].second) {
-      os << x.i << " " << x.j << endl;
+      os << x.i << " " << x.j << '\n';
     }
   }
 
-  os << endl;
-  os << "round " << round() << endl;
+  os << '\n';
+  os << "round " << round() << '\n';
 
   os << "total_score";
   for (auto ts : total_score_) os << " " << ts;
-  os << endl;
+  os << '\n';
 
   os << "status";
   for (auto st : cpu_status_) os << " " << st;
-  os << endl;
+  os << '\n';
 
-  os << endl;
-  os << "city_owners" << endl;
+  os << '\n';
+  os << "city_owners" << '\n';
   for (int owner : city_owner_) os << " " << owner;
-  os << endl;
+  os << '\n';
 
-  os << endl;
-  os << "path_owners" << endl;
+  os << '\n';
+  os << "path_owners" << '\n';
   for (int owner : path_owner_) os << " " << owner;
-  os << endl;
+  os << '\n';
 
-  os << endl;
-  os << "units" << endl;
+  os << '\n';
+  os << "units" << '\n';
   for (int id = 0; id < nb_units(); ++id) {
     print_unit(unit(id), os);
-    os << endl;
+    os << '\n';
   }
-  os << endl;
+  os << '\n';
 }
 
 
@@ -163,8 +166,6 @@ void Board::print_results () const {
 
 void Board::next(const vector<Action>& act, ostream& os) {
 
-  _my_assert(ok(), "Invariants are not satisfied.");
-
   ++round_;
 
   int np = nb_players();
@@ -178,16 +179,16 @@ void Board::next(const vector<Action>& act, ostream& os) {
       int id = m.id;
       Dir dir = m.dir;
       if (not unit_ok(id))
-        cerr << "warning: id out of range : " << id << endl;
+        _log_warning("id out of range : " << id);
       else if (unit(id).player != pl)
-        cerr << "warning: unit " << id << " of player " << unit(id).player
-             << " not owned by " << pl << endl;
+        _log_warning("unit " << id << " of player " << unit(id).player
+                     << " not owned by " << pl);
       else {
         // Here it is an assert because repetitions should have already been filtered out.
         _my_assert(not seen[id], "More than one command for the same unit.");
         seen[id] = true;
         if (not dir_ok(dir))
-          cerr << "warning: direction not valid: " << dir << endl;
+          _log_warning("direction not valid: " << dir);
         else if (dir != NONE)
           v.push_back(Command(id, dir));
       }
@@ -218,13 +219,44 @@ void Board::next(const vector<Action>& act, ostream& os) {
 
   compute_total_scores();
 
-  _my_assert(ok(), "Invariants are not satisfied.");
+  if (Check::full(round())) {
+    _my_assert(ok(), "Invariants are not satisfied.");
+  }
+  else if (Check::enabled()) {
+    _my_assert(touched_ok(), "Invariants of the cells touched in this round are not satisfied.");
+  }
+  touched_.clear();
 }
 
 
-void Board::spawn(const vector<int>& gen) {
+bool Board::touched_ok() const {
+  for (Pos p : touched_) {
+    int id = grid_[p.i][p.j].unit_id;
+    if (id == -1) continue;
+    if (grid_[p.i][p.j].type == WATER) {
+      cerr << "error: WATER cells cannot have units" << endl;
+      return false;
+    }
+    if (not unit_ok(id) or unit_[id].pos != p) {
+      cerr << "error: mismatch with unit identifiers at position " << p << endl;
+      return false;
+    }
+    const Unit& u = unit_[id];
+    if (u.health < 0) {
+      cerr << "error: health cannot be negative" << endl;
+      return false;
+    }
+    if (not player_ok(u.player) or
+        find(orks_[u.player].begin(), orks_[u.player].end(), id) == orks_[u.player].end()) {
+      cerr << "error: mismatch with players of unit " << id << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
 
-  // Generate set of candidate positions for generation.
+void Board::init_coast() {
   set<Pos> cands;
   for (int i = 0; i < rows(); ++i) {
     int j;
@@ -234,16 +266,46 @@ void Board::spawn(const vector<int>& gen) {
     for (j = cols()-1; j >= 0 and cell(i, j).type == WATER; --j) ;
     if (j >= 0)     cands.insert(Pos(i, j));
   }
+  coast_ = vector<Pos>(cands.begin(), cands.end());
+
+  coast_tree_ = vector<int>(coast_.size() + 1, 0);
+  nb_coast_left_ = 0;
+  for (int k = 0; k < int(coast_.size()); ++k) add_coast(k, 1);
+}
 
-  // Regenerate killed units using valid candidate positions.
+
+void Board::add_coast(int k, int d) {
+  nb_coast_left_ += d;
+  for (int x = k + 1; x < int(coast_tree_.size()); x += x & -x) coast_tree_[x] += d;
+}
+
+
+int Board::kth_coast(int k) const {
+  int n = coast_tree_.size() - 1;
+  int x = 0;
+  int step = 1;
+  while (2*step <= n) step *= 2;
+  for (; step > 0; step /= 2)
+    if (x + step <= n and coast_tree_[x + step] <= k) {
+      x += step;
+      k -= coast_tree_[x];
+    }
+  return x;
+}
+
+
+void Board::spawn(const vector<int>& gen) {
+
+  // Regenerate killed units using valid candidate positions,
+  // trying each of them at most once.
+  vector<int> tried;
   for (int id : gen) {
     Pos pos = Pos(-1, -1);
-    while (pos == Pos(-1, -1) and not cands.empty()) {
-      int k = random(0, cands.size()-1);
-      auto it = cands.begin();
-      advance(it, k);
-      if (valid_to_spawn(*it)) pos = *it;
-      cands.erase(it);
+    while (pos == Pos(-1, -1) and nb_coast_left_ > 0) {
+      int k = kth_coast(random(0, nb_coast_left_-1));
+      if (valid_to_spawn(coast_[k])) pos = coast_[k];
+      add_coast(k, -1);
+      tried.push_back(k);
     }
     if (pos == Pos(-1, -1)) // This should very very rarely happen.
       for (int i = 0; i < rows() and pos == Pos(-1, -1); ++i)
@@ -253,6 +315,8 @@ void Board::spawn(const vector<int>& gen) {
     _my_assert(pos != Pos(-1, -1), "Cannot find a cell to regenerate units");
     place(id, pos);
   }
+
+  for (int k : tried) add_coast(k, 1);
 }
 
 
@@ -273,6 +337,8 @@ void Board::place(int id, Pos p) {
   _my_assert( pos_ok( p), "Invalid position.");
   unit_[id].pos = p;
   grid_[p.i][p.j].unit_id = id;
+  touched_.push_back(p);
+  count_unit(p, unit_[id].player, 1);
 }
 
 
@@ -284,6 +350,8 @@ void Board::kill(int id, int pl, vector<bool>& killed) {
 
   Unit& u = unit_[id];
   grid_[u.pos.i][u.pos.j].unit_id = -1;
+  touched_.push_back(u.pos);
+  count_unit(u.pos, u.player, -1);
 
   if (pl != u.player) {
     auto& o = orks_[u.player];
@@ -339,92 +407,128 @@ bool Board::move(int id, Dir dir, vector<bool>& killed) {
     c1.unit_id = -1;
     c2.unit_id = id;
     u.pos = p2;
+    touched_.push_back(p1);
+    touched_.push_back(p2);
+    count_unit(p1, u.player, -1);
+    count_unit(p2, u.player,  1);
     return true;
   }
 }
 
 
-void Board::compute_scores_city_or_path(int bonus, const vector<Pos>& v, int& owner) {
+void Board::init_scores () {
+  city_units_    = vector<vector<int>>(city_.size(), vector<int>(nb_players(), 0));
+  path_units_    = vector<vector<int>>(path_.size(), vector<int>(nb_players(), 0));
+  city_changed_  = vector<bool>(city_.size(), false);
+  path_changed_  = vector<bool>(path_.size(), false);
+  cells_income_  = vector<int> (nb_players(), 0);
+  graph_income_  = vector<int> (nb_players(), 0);
+  graph_changed_ = vector<bool>(nb_players(), false);
+}
+
 
-  vector<int> sc(nb_players(), 0);
-  for (Pos p : v) {
-    int uid = cell(p).unit_id;
-    if (uid != -1) ++sc[unit(uid).player];
+void Board::count_unit(Pos p, int pl, int d) {
+  const Cell& c = grid_[p.i][p.j];
+  if (c.city_id != -1) {
+    city_units_[c.city_id][pl] += d;
+    if (not city_changed_[c.city_id]) {
+      city_changed_[c.city_id] = true;
+      changed_cities_.push_back(c.city_id);
+    }
+  }
+  if (c.path_id != -1) {
+    path_units_[c.path_id][pl] += d;
+    if (not path_changed_[c.path_id]) {
+      path_changed_[c.path_id] = true;
+      changed_paths_.push_back(c.path_id);
+    }
   }
+}
+
+
+void Board::update_owner(const vector<int>& units, int value, int& owner) {
   int max_sc = 0;
   int max_pl = -1; // *Only* player with maximum score (-1 if more than one).
   for (int pl = 0; pl < nb_players(); ++pl) {
-    if (sc[pl] > max_sc) {
-      max_sc = sc[pl];
+    if (units[pl] > max_sc) {
+      max_sc = units[pl];
       max_pl = pl;
     }
-    else if (sc[pl] == max_sc) max_pl = -1;
+    else if (units[pl] == max_sc) max_pl = -1;
   }
-  if (max_pl != -1) {     // Change of owner.
-    total_score_[max_pl] += bonus * v.size();
+  if (max_pl != -1 and max_pl != owner) { // Change of owner.
+    if (owner != -1) {
+      cells_income_[owner] -= value;
+      graph_changed_[owner] = true;
+    }
+    cells_income_[max_pl] += value;
+    graph_changed_[max_pl] = true;
     owner = max_pl;
   }
-  else if (owner != -1) { // The owner is the same.
-    total_score_[owner] += bonus * v.size();
-  }
 }
 
 
-int size_of_connected_component_of(int u,
-                                   const vector<vector<int>>& g,
-                                   vector<bool>& mkd) {
-  mkd[u] = true;
-  int s = 1;
-  for (int v : g[u])
-    if (not mkd[v])
-      s += size_of_connected_component_of(v, g, mkd);
-  return s;
+// Returns the root of the tree of x in a union-find, whose size is -parent[root].
+static int root(int x, vector<int>& parent) {
+  while (parent[x] >= 0) {
+    if (parent[parent[x]] >= 0) parent[x] = parent[parent[x]];
+    x = parent[x];
+  }
+  return x;
 }
 
 
-void Board::compute_scores_graph(int pl) {
-  map<int, int> id;
-  int sz = 0;
-  for (int k = 0; k < int(city_.size()); ++k)
-    if (city_owner_[k] == pl) {
-      id[k] = sz;
-      ++sz;
-    }
-  // There could be repeated edges, but there will be few.
-  vector<vector<int>> g(sz);
+int Board::compute_scores_graph(int pl) const {
+  // Joins the cities linked by a path when the three of them are owned by pl.
+  vector<int> parent(city_.size(), -1);
   for (int k = 0; k < int(path_.size()); ++k) {
     int a = path_[k].first.first;
     int b = path_[k].first.second;
     if (path_owner_[k] == pl and
         city_owner_[a] == pl and
         city_owner_[b] == pl) {
-      int ida = id[a];
-      int idb = id[b];
-      g[ida].push_back(idb);
-      g[idb].push_back(ida);
+      int ra = root(a, parent);
+      int rb = root(b, parent);
+      if (ra != rb) {
+        if (parent[ra] > parent[rb]) swap(ra, rb);
+        parent[ra] += parent[rb];
+        parent[rb] = ra;
+      }
     }
   }
 
-  vector<bool> mkd(sz, false);
-  for (int u = 0; u < sz; ++u)
-    if (not mkd[u]) {
-      int s = size_of_connected_component_of(u, g, mkd);
+  int score = 0;
+  for (int k = 0; k < int(city_.size()); ++k)
+    if (city_owner_[k] == pl and parent[k] < 0) {
+      int s = -parent[k];
       _my_assert(0 <= s and s <= 25, "Unexpected size of connected component.");
-      total_score_[pl] += factor_connected_component() * int(1 << s);
+      score += factor_connected_component() * int(1 << s);
     }
+  return score;
 }
 
 
 void Board::compute_total_scores () {
 
-  for (int k = 0; k < int(city_.size()); ++k)
-    compute_scores_city_or_path(bonus_per_city_cell(), city_[k], city_owner_[k]);
+  for (int k : changed_cities_) {
+    update_owner(city_units_[k], bonus_per_city_cell() * city_[k].size(), city_owner_[k]);
+    city_changed_[k] = false;
+  }
+  changed_cities_.clear();
 
-  for (int k = 0; k < int(path_.size()); ++k)
-    compute_scores_city_or_path(bonus_per_path_cell(), path_[k].second, path_owner_[k]);
+  for (int k : changed_paths_) {
+    update_owner(path_units_[k], bonus_per_path_cell() * path_[k].second.size(), path_owner_[k]);
+    path_changed_[k] = false;
+  }
+  changed_paths_.clear();
 
-  for (int pl = 0; pl < nb_players(); ++pl)
-    compute_scores_graph(pl);
+  for (int pl = 0; pl < nb_players(); ++pl) {
+    if (graph_changed_[pl]) {
+      graph_income_[pl] = compute_scores_graph(pl);
+      graph_changed_[pl] = false;
+    }
+    total_score_[pl] += cells_income_[pl] + graph_income_[pl];
+  }
 }
 
 
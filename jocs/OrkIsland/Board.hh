@@ -5,6 +5,8 @@
 #include "Info.hh"
 #include "Action.hh"
 #include "Random.hh"
+#include "Writer.hh"
+#include "Check.hh"
 
 
 /*! \file
@@ -23,6 +25,14 @@ class Board : public Info, public Random_generator {
 
   vector<string> names_;
 
+  // Positions whose unit has changed in this round (maybe repeated).
+  vector<Pos> touched_;
+
+  /**
+   * Checks the invariants that concern the touched positions only.
+   */
+  bool touched_ok() const;
+
   /**
    * Reads the generator method, and generates or reads the grid.
    */
@@ -43,7 +53,7 @@ class Board : public Info, public Random_generator {
   /**
    * Prints some information of the unit.
    */
-  inline static void print_unit (Unit u, ostream& os) {
+  inline static void print_unit (Unit u, Writer& os) {
     os << u.player << ' '
        << u.pos.i  << ' '
        << u.pos.j  << ' '
@@ -52,26 +62,78 @@ class Board : public Info, public Random_generator {
 
   bool valid_to_spawn(Pos pos);
 
+  // Candidate cells to spawn units: the first and the last non-water cell
+  // of every row, sorted. They only depend on the terrain.
+  vector<Pos> coast_;
+
+  // Fenwick tree over coast_, with 1 for the cells not tried yet
+  // in the current call to spawn(), and the number of such cells.
+  vector<int> coast_tree_;
+  int         nb_coast_left_;
+
+  /**
+   * Computes the candidate cells to spawn units.
+   */
+  void init_coast ();
+
+  /**
+   * Adds d to the k-th candidate cell in the Fenwick tree.
+   */
+  void add_coast (int k, int d);
+
+  /**
+   * Returns the index in coast_ of the k-th (from 0) candidate cell not tried yet.
+   */
+  int kth_coast (int k) const;
+
   void place (int id, Pos p);
   
   void spawn(const vector<int>& gen);
   
   void kill(int id, int pl, vector<bool>& killed);
   
+  // Number of units of each player in each city and in each path.
+  vector<vector<int>> city_units_;
+  vector<vector<int>> path_units_;
+
+  // Cities and paths whose units have changed in this round.
+  vector<int>  changed_cities_;
+  vector<int>  changed_paths_;
+  vector<bool> city_changed_;
+  vector<bool> path_changed_;
+
+  // Score that each player gets every round for the cells of the cities
+  // and paths it owns, and for its graph (only valid if not graph_changed_).
+  vector<int>  cells_income_;
+  vector<int>  graph_income_;
+  vector<bool> graph_changed_;
+
+  /**
+   * Prepares the counters for scoring. Must be called before placing units.
+   */
+  void init_scores ();
+
+  /**
+   * Updates the counters after a unit of player pl has arrived at (d = 1)
+   * or left (d = -1) position p.
+   */
+  void count_unit (Pos p, int pl, int d);
+
   /**
    * Computes total scores of all players.
    */
   void compute_total_scores ();
 
   /**
-   * Computes scores due to conquering a city/path with positions v.
+   * Updates the owner of a city/path with the given units of each player,
+   * which is worth value points per round.
    */
-  void compute_scores_city_or_path(int bonus, const vector<Pos>& v, int& owner);
+  void update_owner(const vector<int>& units, int value, int& owner);
 
   /**
-   * Computes scores due to the graph of player pl.
+   * Computes the score per round due to the graph of player pl.
    */
-  void compute_scores_graph(int pl);
+  int compute_scores_graph(int pl) const;
   
   /**
    * Tries to apply a move. Returns true if it could.
@@ -609,9 +671,9 @@ public:
   void print_names (ostream& os) const;
 
   /**
-   * Prints the state of the board to a stream.
+   * Prints the state of the board to a writer.
    */
-  void print_state (ostream& os) const;
+  void print_state (Writer& os) const;
 
   /**
    * Prints the results and the names of the winning players.
@@ -21,6 +21,7 @@
 #include <algorithm>
 
 #include "Defs.hh"
+#include "Log.hh"
 
 using namespace std;
 
@@ -34,7 +35,7 @@ using namespace std;
 /**
  * Assert with message.
  */
-#define _my_assert(b, s) { if (not (b)) { cerr << "error: " << s << endl; assert(b); } }
+#define _my_assert(b, s) { if (not (b)) { Log::flush(); cerr << "error: " << s << endl; assert(b); } }
 
 
 /**
@@ -52,13 +52,13 @@ struct PLAYER_NAME : public Player {
 
         // move pacman
         Pos p = pacman(me()).pos;
-        if (not pac_can_move(p, dirs[0]) or rand()%1000==0) dirs[0] = rand_dir(dirs[0]);
+        if (not pac_can_move(p, dirs[0]) or randomize()%1000==0) dirs[0] = rand_dir(dirs[0]);
         move_my_pacman(dirs[0]);
 
         // move ghosts
         for (int i=0; i < nb_ghosts(); ++i) {
             Pos q = ghost(me(), i).pos;
-            if (not ghost_can_move(q, dirs[i+1]) or rand()%1000==0) dirs[i+1] = rand_dir( dirs[i+1]);
+            if (not ghost_can_move(q, dirs[i+1]) or randomize()%1000==0) dirs[i+1] = rand_dir( dirs[i+1]);
             move_my_ghost(i, dirs[i+1]);
         }
     }
@@ -84,7 +84,7 @@ struct PLAYER_NAME : public Player {
     Dir rand_dir (Dir notd) {
         Dir a[] = {Left, Right, Bottom, Top};
         while (true) {
-            Dir d = a[rand() % 4];
+            Dir d = a[randomize() % 4];
             if (d != notd) return d;
         }
     }
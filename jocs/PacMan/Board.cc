@@ -189,9 +189,9 @@ void Board::print_preamble (ostream& os) const {
 
 
 
-void Board::print (ostream& os) const {
-    os << endl;
-    os << "round " << round() << endl;
+void Board::print (Writer& os) const {
+    os << '\n';
+    os << "round " << round() << '\n';
     for (int i = 0; i < rows_; ++i) {
         for (int j = 0; j < cols_; ++j) {
             CType c = cell(i, j).type;
@@ -205,14 +205,14 @@ void Board::print (ostream& os) const {
             else if (c == Mushroom) os << 'M';
             else assert(0);
         }
-        os << endl;
+        os << '\n';
     }
     os << "score";
     for (int i = 0; i < nb_players(); ++i) os << " " << score(i);
-    os << endl;
+    os << '\n';
     os << "status";
     for (int i = 0; i < nb_players(); ++i) os << " " << status(i);
-    os << endl;
+    os << '\n';
     for (int id = 0; id < nb_robots(); ++id) {
         string s;
         if (robot(id).type == PacMan) s = "pacman";
@@ -223,9 +223,9 @@ void Board::print (ostream& os) const {
             << robot(id).pos.i << " "
             << robot(id).pos.j << " "
             << robot(id).time << " "
-            << (robot(id).alive ? 'a' : 'd') << endl;
+            << (robot(id).alive ? 'a' : 'd') << '\n';
     }
-    os << endl;
+    os << '\n';
 }
 
 
@@ -255,10 +255,22 @@ void Board::print_debug (ostream& os) const {
 
 
 
-Board Board::next (const vector<Action>& as, Action& actions_done, const Board& b0) const {
+void Board::catch_up (const Board& b) {
+    for (const Pos& p : b.changed_) cells_[p.i][p.j] = b.cells_[p.i][p.j];
+    changed_.clear();
 
-    // b will be the new board we shall return
-    Board b = *this;
+    round_  = b.round_;
+    robots_ = b.robots_;
+    score_  = b.score_;
+    status_ = b.status_;
+    rng_    = b.rng_;
+}
+
+
+void Board::next (const vector<Action>& as, Action& actions_done, const Board& b0, Board& b) const {
+
+    // b will be the new board
+    b.catch_up(*this);
 
     // increment the round
     ++b.round_;
@@ -268,7 +280,7 @@ Board Board::next (const vector<Action>& as, Action& actions_done, const Board&
     for (int player = 0; player < nb_players(); ++player) {
         turns[player] = player;
     }
-    random_shuffle(turns.begin(), turns.end());
+    b.shuffle(turns);
 
     // move each robot
     vector<bool> moved(nb_robots(), false);
@@ -306,17 +318,17 @@ Board Board::next (const vector<Action>& as, Action& actions_done, const Board&
                 for (set<Pos>::iterator it = b.cageset_.begin();  it != b.cageset_.end(); ++it) {
                     v.push_back(*it);
                 }
-                cerr << v.size() << endl;
-                random_shuffle(v.begin(), v.end());
+                _log_debug("cage cells " << v.size());
+                b.shuffle(v);
                 
                 for (int i = 0; i <int(v.size()) and not fnd; ++i) {
                     if (b.cell(v[i]).id == -1) {
-                        b.cells_[v[i].i][v[i].j].id = id;
+                        b.cell_priv(v[i]).id = id;
                         b.robots_[id].pos = v[i];
                         r.alive = true;
                         fnd = true;
                 }   }
-                if (not fnd) cerr << "info: cannot place ghost in cage." << endl;
+                if (not fnd) _log_info("cannot place ghost in cage.");
             }
         }
         
@@ -326,21 +338,19 @@ Board Board::next (const vector<Action>& as, Action& actions_done, const Board&
                 bool fnd = false;
 
                 for (int reps = 0; reps < 100 and not fnd; ++reps) {
-                    Pos p = Pos(random() % rows(), random() % cols());
+                    Pos p = Pos(b.randomize() % rows(), b.randomize() % cols());
                     fnd = b.cell(p).type == Empty;
                     for (int ii = -2; ii <= 2; ++ii) {
                         for (int jj = -2; jj <= 2; ++jj) {
                             fnd = fnd and (not b.pos_ok(p.i + ii, p.j + jj) or b.cell(p.i + ii, p.j + jj).id == -1);
                     }   }
                     if (fnd) {
-                        b.cells_[p.i][p.j].id = id;
+                        b.cell_priv(p).id = id;
                         b.robots_[id].pos = p;
                         r.alive = true;
                 }   }
-                if (not fnd) cerr << "info: cannot place pacman in board." << endl;            
+                if (not fnd) _log_info("cannot place pacman in board.");            
     }   }   }
-
-    return b;
 }
 
 
@@ -361,8 +371,8 @@ bool Board::move (int player, int id, Dir d, const Board& b0) {
     Pos p2 = dest(p1, d);
     if (not pos_ok(p2)) return false;
 
-    Cell& c1 = cells_[p1.i][p1.j];
-    Cell& c2 = cells_[p2.i][p2.j];
+    Cell& c1 = cell_priv(p1);
+    Cell& c2 = cell_priv(p2);
     CType& t2 = c2.type;
 
     if (t2 == Wall) return false;
@@ -377,13 +387,13 @@ bool Board::move (int player, int id, Dir d, const Board& b0) {
             if (r2.type == Ghost) {
                 return false;
             } else if (r2.type == PacMan) {
-                cells_[r2.pos.i][r2.pos.j].id = -1;
+                cell_priv(r2.pos).id = -1;
                 r2.alive = false;
                 r2.time = regen_time();
                 r2.pos = Pos(0, 0);
                 score_[player] += pn_pacman();
             } else if (r2.type == PowerPacMan) {
-                cells_[r1.pos.i][r1.pos.j].id = -1;
+                cell_priv(r1.pos).id = -1;
                 r1.alive = false;
                 r1.pos = Pos(0, 0);
                 r1.time = regen_time();
@@ -393,7 +403,7 @@ bool Board::move (int player, int id, Dir d, const Board& b0) {
             } else assert(0);
         } else if (r1.type == PacMan) {
             if (r2.type == Ghost) {
-                cells_[r1.pos.i][r1.pos.j].id = -1;
+                cell_priv(r1.pos).id = -1;
                 r1.alive = false;
                 r1.pos = Pos(0, 0);
                 r1.time = regen_time();
@@ -407,7 +417,7 @@ bool Board::move (int player, int id, Dir d, const Board& b0) {
             } else assert(0);
         } else if (r1.type == PowerPacMan) {
             if (r2.type == Ghost) {
-                cells_[r2.pos.i][r2.pos.j].id = -1;
+                cell_priv(r2.pos).id = -1;
                 r2.alive = false;
                 r2.pos = Pos(0, 0);
                 r2.time = regen_time();
@@ -445,7 +455,7 @@ bool Board::move (int player, int id, Dir d, const Board& b0) {
         for (int i = 0; i < nb_robots(); ++i) {
             Robot& r3 = robots_[i];
             if (r3.alive and r3.player != player and r3.type == Ghost) {
-                cells_[r3.pos.i][r3.pos.j].id = -1;
+                cell_priv(r3.pos).id = -1;
                 r3.alive = false;
                 r3.pos = Pos(0, 0);
                 r3.time = 3;
@@ -459,10 +469,10 @@ bool Board::move (int player, int id, Dir d, const Board& b0) {
         score_[player] += pn_bonus();
         for (int i = 0; i < rows(); ++i) {
             for (int j = 0; j < cols(); ++j) {
-                if (b0.cell(i, j).type == Dot) cells_[i][j].type = Dot;
-                if (b0.cell(i, j).type == Pill) cells_[i][j].type = Pill;
-                if (b0.cell(i, j).type == Bonus) cells_[i][j].type = Bonus;
-                if (b0.cell(i, j).type == Hammer) cells_[i][j].type = Hammer;
+                if (b0.cell(i, j).type == Dot) cell_priv(Pos(i, j)).type = Dot;
+                if (b0.cell(i, j).type == Pill) cell_priv(Pos(i, j)).type = Pill;
+                if (b0.cell(i, j).type == Bonus) cell_priv(Pos(i, j)).type = Bonus;
+                if (b0.cell(i, j).type == Hammer) cell_priv(Pos(i, j)).type = Hammer;
     }   }   }
 
     c2.id = c1.id;
@@ -3,6 +3,7 @@
 
 #include "Utils.hh"
 #include "PosDir.hh"
+#include "Writer.hh"
 
 using namespace std;
 
@@ -98,6 +99,10 @@ class Board {
     vector<double> status_;     // cpu status. <0: died, 0..1: %of cpu time limit
     set<Pos> cageset_;          // set of positions inside the cage
 
+    Random_generator rng_;
+
+    // Positions of the cells written while computing this board (maybe repeated).
+    vector<Pos> changed_;
 
 
     /**
@@ -111,9 +116,9 @@ class Board {
     void print_preamble (ostream& os) const;
 
     /**
-     * Print the board to a stream.
+     * Print the board to a writer.
      */
-    void print (ostream& os) const;
+    void print (Writer& os) const;
 
     /**
      * Print simplified board to a stream.
@@ -129,17 +134,48 @@ class Board {
     }
 
     /**
-     * Computes the next board aplying the given actions as to the current board.
+     * Computes into b the next board aplying the given actions as to the current board.
      * It also returns the actual actions performed.
      * b0 is the start board.
+     * b must be a copy of this board or the board this one was computed from,
+     * so that boards can be used alternately and only changed cells are copied.
+     */
+    void next (const vector<Action>& as, Action& actions_done, const Board& b0, Board& b) const;
+
+    /**
+     * Makes this board equal to b, which must have been computed from this one
+     * (or be equal to it). Settings and names are not copied as they never change.
      */
-    Board next (const vector<Action>& as, Action& actions_done, const Board& b0) const;
+    void catch_up (const Board& b);
+
+    /**
+     * Returns the cell at p, noting that it is written.
+     */
+    inline Cell& cell_priv (const Pos& p) {
+        changed_.push_back(p);
+        return cells_[p.i][p.j];
+    }
 
     /**
      * Applies a basic move.
      */
     bool move (int pl, int id, Dir dir, const Board& b0);
 
+    /**
+     * Sets the random seed.
+     */
+    inline void srandomize (int s) {
+        rng_.srandomize(s);
+    }
+
+    /**
+     * Randomly permutes a vector.
+     */
+    template <typename T>
+    void shuffle (vector<T>& v) {
+        for (int i = 0; i < sze(v); ++i) swap(v[i], v[i + randomize() % (sze(v) - i)]);
+    }
+
 
 
 public:
@@ -151,6 +187,14 @@ public:
     {   }
 
 
+    /**
+     * Returns a pseudo-random number between 0 and 2147483646.
+     */
+    inline int randomize () {
+        return rng_.randomize();
+    }
+
+
     /**
      * Returns the number of rounds in the game.
      */
@@ -5,60 +5,72 @@
 using namespace std;
 
 
-void Game::run (vector<string> names, istream& is, ostream& os) {
-    cerr << "info: loading game" << endl;
+void Game::run (vector<string> names, istream& is, ostream& os, int seed) {
+    _log_info("loading game");
     Board b0(is);
-    cerr << "info: loaded game" << endl;
+    _log_info("loaded game");
+
+    b0.srandomize(seed);
 
     if (int(names.size()) != b0.nb_players()) {
-        cerr << "fatal: wrong number of players." << endl;
+        _log_error("wrong number of players.");
         exit(EXIT_FAILURE);
     }
 
     vector<Player*> players;        
     for (int player = 0; player < b0.nb_players(); ++player) {
         string name = names[player];
-        cerr << "info: loading player " << name << endl;
+        _log_info("loading player " << name);
         players.push_back(Registry::new_player(name));
+        players[player]->srandomize(seed + player + 1);
         b0.names_[player] = name;
     }
-    cerr << "info: players loaded" << endl;
+    _log_info("players loaded");
 
     // ofstream ofs("/tmp/debug.txt");
 
-    b0.print_preamble(os);
-    b0.print(os);
+    // Each round is formatted into w and written to os in one go.
+    Writer w;
+    b0.print_preamble(w);
+    b0.print(w);
+    w.write_to(os);
 
     // b0.print_debug(ofs);
     
+    // b1 is the current board and b2 the one where the next is computed.
     Board b1 = b0;
+    Board b2 = b0;
     for (int round = 1; round < b0.nb_rounds(); ++round) {
-        cerr << "info: start round " << round << endl;
-        os << "actions" << endl;
+        _log_info("start round " << round);
+        w << "actions" << endl;
         vector<Action> actions;
         for (int player = 0; player < b0.nb_players(); ++player) {
-            cerr << "info:     start player " << player << endl;
+            _log_info("    start player " << player);
+            Log::flush(); // the player may write to stderr too
             Action a;
+            int s = players[player]->randomize(); // keep the generator of the player
             players[player]->reset(player, b1, a);
+            players[player]->srandomize(s);
             players[player]->play();
             actions.push_back(*players[player]);
 
-            os << player << endl;
-            Action(*players[player]).print(os);
-            cerr << "info:     end player " << player << endl;
+            w << player << endl;
+            Action(*players[player]).print(w);
+            _log_info("    end player " << player);
         }
         Action actions_done;
-        cerr << "start next" << endl;
-        Board b2 = b1.next(actions, actions_done, b0);
-        cerr << "end next" << endl;
-        os << endl << "movements" << endl;
-        actions_done.print(os);
-        b2.print(os);
+        _log_debug("start next");
+        b1.next(actions, actions_done, b0, b2);
+        _log_debug("end next");
+        w << endl << "movements" << endl;
+        actions_done.print(w);
+        b2.print(w);
+        w.write_to(os);
         // b2.print_debug(ofs);
-        b1 = b2;
-        cerr << "info: end round " << round << endl;
+        swap(b1, b2);
+        _log_info("end round " << round);
     }
-    cerr << "info: game played" << endl;
+    _log_info("game played");
 }
 
 
@@ -317,7 +317,7 @@ Board::Board (istream& is) {
 	break;
       }
     default:
-      cerr << "This type of bonus is not valid" << endl;
+      _log_warning("This type of bonus is not valid");
       break;
     }
   }
@@ -331,6 +331,9 @@ Board::Board (istream& is) {
   assert(attacks_.size() 	== (unsigned) nb_attack());
   assert(defenses_.size()	== (unsigned) nb_defense());
 
+  init_walls();
+  init_spawn();
+
   assert(ok());
 
 }
@@ -365,20 +368,20 @@ void Board::print_preamble (ostream& os) const {
 }
 
 
-void Board::print (ostream& os) const {
-  os << endl;
-  os << "round " << round() << endl << endl;
+void Board::print (Writer& os) const {
+  os << '\n';
+  os << "round " << round() << "\n\n";
 	
-  os << "board " << endl << endl;
+  os << "board " << "\n\n";
 
   os << "   ";
   for (int j = 0; j < cols(); ++j) os << (j / 10);
-  os << endl;
+  os << '\n';
 
   os << "   ";
   for (int j = 0; j < cols(); ++j) os << (j % 10);
-  os << endl;
-  os << endl;
+  os << '\n';
+  os << '\n';
 
   for (int i = 0; i < rows(); ++i) {
     os << (i / 10) << (i % 10) << " "; // Adding col numbers.
@@ -413,16 +416,16 @@ void Board::print (ostream& os) const {
 	/* no break, unreachable code. */
       };
     }
-    os << endl;
+    os << '\n';
   }
-  os << endl;
+  os << '\n';
 
   os << "status";
   for (int i = 0; i < nb_players(); ++i) os << " " << fixed << setprecision(3) << status_[i];
-  os << endl << endl;
+  os << "\n\n";
 
-  os << "poquemon" << endl;
-  os << "id  ply  i  j  at  def  ab  ped  pts  time  alive" << endl;
+  os << "poquemon" << '\n';
+  os << "id  ply  i  j  at  def  ab  ped  pts  time  alive" << '\n';
   for (int i = 0; i < nb_total_poquemon(); ++i)
     {
       os << poquemons_[i].id << "  " << poquemons_[i].player << "  ";
@@ -430,61 +433,83 @@ void Board::print (ostream& os) const {
       os << poquemons_[i].attack << "  " << poquemons_[i].defense << "  ";
       os << poquemons_[i].scope << "  " << poquemons_[i].stones << "  ";
       os << poquemons_[i].points << "  " << poquemons_[i].time << "  ";
-      if (poquemons_[i].alive) os << 'a' << endl;
-      else os << 'd' << endl;
+      if (poquemons_[i].alive) os << 'a' << '\n';
+      else os << 'd' << '\n';
     }
-  os << endl;
+  os << '\n';
 
-  os << "walls" << endl;
-  os << "i  j  time  present" << endl;
+  os << "walls" << '\n';
+  os << "i  j  time  present" << '\n';
   for (int i = 0; i < nb_ghost_wall(); ++i)
     os << ghostWall_[i].pos.i << "  " << ghostWall_[i].pos.j << "  "
-       << ghostWall_[i].time << " " << ghostWall_[i].present << endl;
-  os << endl;
+       << ghostWall_[i].time << " " << ghostWall_[i].present << '\n';
+  os << '\n';
 
-  os << "bonus" << endl;
-  os << "type  i  j  pts  time present" << endl;
+  os << "bonus" << '\n';
+  os << "type  i  j  pts  time present" << '\n';
   // Point bonus.
   for (int i = 0; i < nb_point(); ++i)
     os << "P" << "  " << "  " << points_[i].pos.i << "  "
        << points_[i].pos.j << "  " << points_[i].value << "  "
-       << points_[i].time << " " << points_[i].present << endl;
+       << points_[i].time << " " << points_[i].present << '\n';
 		
   // Stones.
   for (int i = 0; i < nb_stone(); ++i)
     os << "S" << "  " << "  " << stones_[i].pos.i << "  "
        << stones_[i].pos.j << " " << stones_[i].value << " "
-       << stones_[i].time << " " << stones_[i].present << endl;
+       << stones_[i].time << " " << stones_[i].present << '\n';
 		
   // Scope up bonus.
   for (int i = 0; i < nb_scope(); ++i)
     os << "R" << "  " << "  " << scopes_[i].pos.i << "  "
        << scopes_[i].pos.j << " " << scopes_[i].value << " "
-       << scopes_[i].time << " " << scopes_[i].present << endl;
+       << scopes_[i].time << " " << scopes_[i].present << '\n';
 		
   // Attack up bonus.
   for (int i = 0; i < nb_attack(); ++i)
     os << "A" << "  " << "  " << attacks_[i].pos.i << "  "
        << attacks_[i].pos.j << " " << attacks_[i].value << " "
-       << attacks_[i].time << " " << attacks_[i].present << endl;
+       << attacks_[i].time << " " << attacks_[i].present << '\n';
 		
   // Defense up bonus.
   for (int i = 0; i < nb_defense(); ++i)
     os << "D" << "  " << "  " << defenses_[i].pos.i << "  "
        << defenses_[i].pos.j << " " << defenses_[i].value << " "
-       << defenses_[i].time << " " << defenses_[i].present << endl;
+       << defenses_[i].time << " " << defenses_[i].present << '\n';
 		
-  os << endl;
+  os << '\n';
 }
 
 
-Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
-
+void Board::catch_up (const Board& b) {
+  for (const Pos& p : b.changed_)
+    cells_[p.i][p.j] = b.cells_[p.i][p.j];
+  changed_.clear();
+  synced_ = 0;
+  for (const Pos& p : b.changed_)
+    update_spawn(p);
+
+  // The visibility index only changes where ghost walls have toggled.
+  for (int k = 0; k < nb_ghost_wall(); ++k)
+    if (ghostWall_[k].present != b.ghostWall_[k].present)
+      update_walls(ghostWall_[k].pos);
+
+  round_     = b.round_;
+  poquemons_ = b.poquemons_;
+  ghostWall_ = b.ghostWall_;
+  points_    = b.points_;
+  stones_    = b.stones_;
+  scopes_    = b.scopes_;
+  attacks_   = b.attacks_;
+  defenses_  = b.defenses_;
+  status_    = b.status_;
+  rgen       = b.rgen;
+}
 
-  assert(ok());
+void Board::next (const vector<Action>& asked, vector<Action>& done, Board& b) const {
 
-  // b will be the new board we shall return
-  Board b = *this;
+  // b will be the new board
+  b.catch_up(*this);
 
   // increment the round
   ++b.round_;
@@ -534,7 +559,7 @@ Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
 	break;
       }
     default:
-      cerr << "Invalid action asked of player " << player << endl;
+      _log_warning("Invalid action asked of player " << player);
       break;
     }
   }
@@ -555,11 +580,12 @@ Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
 	  assert(id_cell >= 0 and id_cell < nb_total_poquemon());
 	  b.poquemons_[id_cell].alive 	= false;
 	  b.poquemons_[id_cell].time 	= player_regen_time();
-	  b.cells_[gw.pos.i][gw.pos.j].id = -1;
+	  b.cell_priv(gw.pos).id = -1;
 	}
-	b.cells_[gw.pos.i][gw.pos.j].type = Wall;
+	b.cell_priv(gw.pos).type = Wall;
       }
-      else b.cells_[gw.pos.i][gw.pos.j].type = Empty;
+      else b.cell_priv(gw.pos).type = Empty;
+      b.update_walls(gw.pos);
     }
   }
 
@@ -571,24 +597,13 @@ Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
     if (not pkm.alive) {
       if (pkm.time > 0) --pkm.time;
       if (pkm.time == 0) {
-	bool fnd = false;
-	for (int reps = 0; reps < 200 and not fnd; ++reps) {
-	  Pos p = Pos(b.randomize() % rows(), b.randomize() % cols());
-	  fnd = (b.cell(p).type == Empty);
-	  for (int ii = -2; fnd and ii <= 2; ++ii)
-	    for (int jj = -2; fnd and jj <= 2; ++jj)
-	      // we check there aren't any other poquemon
-	      // in a radius of 2 respect the cell
-	      // that the main poquemon will appear.
-	      fnd = 	(not b.pos_ok(p.i + ii, p.j + jj)) 
-		or b.cell(p.i + ii, p.j + jj).id == -1;
-	  if (fnd) {
-	    b.cells_[p.i][p.j].id = id;
-	    pkm.pos   = p;
-	    pkm.alive = true;
-	  }
+	// If there is no room, the Poquémon tries again next round.
+	Pos p = b.random_safe_position();
+	if (pos_ok(p)) {
+	  b.cell_priv(p).id = id;
+	  pkm.pos   = p;
+	  pkm.alive = true;
 	}
-	if (not fnd) cerr << "info: cannot place poquemon on board." << endl;
       }
     }
   }
@@ -598,9 +613,13 @@ Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
     PointBonus& pb = b.points_[i];
     if (pb.time > 0) --pb.time;
     if (pb.time == 0 and not pb.present) {
-      pb.present = true;
-      pb.value = ((rand() % 5) + 1) * 100;
-      pb.pos = get_random_safe_position(Point, b);
+      Pos p = b.random_safe_position();
+      if (pos_ok(p)) {
+	pb.present = true;
+	pb.value = b.randomize(1, 5) * 100;
+	pb.pos = p;
+	b.cell_priv(p).type = Point;
+      }
     }
   }
 	
@@ -609,8 +628,12 @@ Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
     StoneBonus& s = b.stones_[i];
     if (s.time > 0) --s.time;
     if (s.time == 0 and not s.present) {
-      s.present = true;
-      s.pos = get_random_safe_position(Stone, b);
+      Pos p = b.random_safe_position();
+      if (pos_ok(p)) {
+	s.present = true;
+	s.pos = p;
+	b.cell_priv(p).type = Stone;
+      }
     }
   }
 	
@@ -619,8 +642,12 @@ Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
     ScopeBonus& r = b.scopes_[i];
     if (r.time > 0) --r.time;
     if (r.time == 0 and not r.present) {
-      r.present = true;
-      r.pos = get_random_safe_position(Scope, b);
+      Pos p = b.random_safe_position();
+      if (pos_ok(p)) {
+	r.present = true;
+	r.pos = p;
+	b.cell_priv(p).type = Scope;
+      }
     }
   }
 	
@@ -629,8 +656,12 @@ Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
     AttackBonus& a = b.attacks_[i];
     if (a.time > 0) --a.time;
     if (a.time == 0 and not a.present) {
-      a.present = true;
-      a.pos = get_random_safe_position(Attack, b);
+      Pos p = b.random_safe_position();
+      if (pos_ok(p)) {
+	a.present = true;
+	a.pos = p;
+	b.cell_priv(p).type = Attack;
+      }
     }
   }
 
@@ -639,13 +670,22 @@ Board Board::next (const vector<Action>& asked, vector<Action>& done) const {
     DefenseBonus& d = b.defenses_[i];
     if (d.time > 0) --d.time;
     if (d.time == 0 and not d.present) {
-      d.present = true;
-      d.pos = get_random_safe_position(Defense, b);
+      Pos p = b.random_safe_position();
+      if (pos_ok(p)) {
+	d.present = true;
+	d.pos = p;
+	b.cell_priv(p).type = Defense;
+      }
     }
   }
 
-  assert(b.ok());
-  return b;
+  b.sync_spawn();
+  if (Check::full(b.round())) {
+    check(b.ok());
+  }
+  else if (Check::enabled()) {
+    check(b.touched_ok());
+  }
 }
 
 bool Board::apply_attack(int id, AType a, Dir d) {
@@ -670,8 +710,8 @@ bool Board::apply_attack(int id, AType a, Dir d) {
       Poquemon& pkm2 = poquemons_[cell(p).id];
       assert(pkm2.alive);
       if (pkm2.defense <= pkm.attack) {
-	cells_[p.i][p.j].id = -1;
-	cells_[p.i][p.j].type = Empty;
+	cell_priv(p).id = -1;
+	cell_priv(p).type = Empty;
 	pkm2.alive	= false;
 	pkm2.time	= player_regen_time();
 	pkm.points	+= pkm2.points * (battle_reward()/100.0);
@@ -704,10 +744,10 @@ bool Board::apply_move(int id, AType a, Dir d) {
 
   if (not pos_ok(p2)) return false;
 
-  Cell& c1 = cells_[p1.i][p1.j];
+  Cell& c1 = cell_priv(p1);
   assert(c1.id == id);
 
-  Cell& c2 = cells_[p2.i][p2.j];
+  Cell& c2 = cell_priv(p2);
 
   if (c2.type == Wall) return false;
 
@@ -802,33 +842,10 @@ bool Board::exists_objective(Pos p, Dir d, int distMax) const {
   return false;
 }
 
-Pos Board::get_random_safe_position(CType c, Board& b) const {
-  bool fnd = false;
-  for (int reps = 0; reps < 200 and not fnd; ++reps) {
-    Pos p = Pos(b.randomize() % rows(), b.randomize() % cols());
-    fnd = (b.cells_[p.i][p.j].type == Empty);
-    for (int ii = -2; fnd and ii <= 2; ++ii)
-      for (int jj = -2; fnd and jj <= 2; ++jj) {
-	// we check there aren't any other poquemon in a radius
-	// of 2 respect the cell that the main bonus will
-	// appear, to avoid advantatges.
-	fnd = (not b.pos_ok(p.i + ii, p.j + jj) ) or b.cell(p.i + ii, p.j + jj).id == -1;
-	fnd = fnd and not b.is_ghost_wall(p, ghostWall_);
-      }
-    if (fnd) {
-      b.cells_[p.i][p.j].id = -1;
-      b.cells_[p.i][p.j].type = c;
-      return p;
-    }
-  }
-  if (not fnd) cerr << "info: cannot place " << c << " on board." << endl;
-  return Pos(-1,-1);
-}
-
-bool Board::is_ghost_wall(Pos p, vector<GhostWall> gw) const {
-  for(int i = 0; i < nb_ghost_wall(); ++i)
-    if (gw[i].pos == p) return true;
-  return false;
+Pos Board::random_safe_position() {
+  sync_spawn();
+  if (nb_spawn_ok_ == 0) return Pos(-1, -1);
+  return kth_spawn_position(randomize() % nb_spawn_ok_);
 }
 
 int Board::score (int id) const {
@@ -843,39 +860,39 @@ int Board::score (int id) const {
 bool Board::ok(void) const {
 
   if (int(cells_.size()) != rows_) {
-    cerr << "debug: problems with row dimension of the board." << endl;
+    _log_error("problems with row dimension of the board.");
     return false;
   }
   if (int(cells_[0].size()) != cols_) {
-    cerr << "debug: problems with col dimension of the board." << endl;
+    _log_error("problems with col dimension of the board.");
     return false;
   }
   if (int(poquemons_.size()) != nb_players_ * nb_poquemon_) {
-    cerr << "debug: problems with number of agents." << endl;
+    _log_error("problems with number of agents.");
     return false;
   }
   if (int(names_.size()) != nb_players_) {
-    cerr << "debug: problems with number of players." << endl;
+    _log_error("problems with number of players.");
     return false;
   }
   if (int(points_.size()) != nb_point_) {
-    cerr << "debug: wrong size of vector of points bag." << endl;
+    _log_error("wrong size of vector of points bag.");
     return false;
   }
   if (int(stones_.size()) != nb_stone_) {
-    cerr << "debug: wrong size of vector of stones." << endl;
+    _log_error("wrong size of vector of stones.");
     return false;
   }
   if (int(scopes_.size()) != nb_scope_) {
-    cerr << "debug: wrong size of vector of scope bonus." << endl;
+    _log_error("wrong size of vector of scope bonus.");
     return false;
   }	
   if (int(attacks_.size()) != nb_attack_) {
-    cerr << "debug: wrong size of vector of attacks bonus." << endl;
+    _log_error("wrong size of vector of attacks bonus.");
     return false;
   }	
   if (int(defenses_.size()) != nb_defense_) {
-    cerr << "debug: wrong size of vector of defenses bonus." << endl;
+    _log_error("wrong size of vector of defenses bonus.");
     return false;
   }
 
@@ -889,44 +906,44 @@ bool Board::ok(void) const {
     for (int j = 0; j < cols(); ++j) {
 
       if (cells_[i][j].pos != Pos(i, j)) {
-	cerr << "debug: problem with positions in cells." << endl;
+	_log_error("problem with positions in cells.");
 	return false;
       }
 
       if (i == 0          and cells_[i][j].type != Wall) {
-	cerr << "debug: borders of board should be walls (1)." << endl;
+	_log_error("borders of board should be walls (1).");
 	return false;
       }
       if (i == rows() - 1 and cells_[i][j].type != Wall) {
-	cerr << "debug: borders of board should be walls (2)." << endl;
+	_log_error("borders of board should be walls (2).");
 	return false;
       }
       if (j == 0          and cells_[i][j].type != Wall) {
-	cerr << "debug: borders of board should be walls (3)." << endl;
+	_log_error("borders of board should be walls (3).");
 	return false;
       }
       if (j == cols() - 1 and cells_[i][j].type != Wall) {
-	cerr << "debug: borders of board should be walls (4)." << endl;
+	_log_error("borders of board should be walls (4).");
 	return false;
       }
 			
       int id = cells_[i][j].id;
       if (id != -1) {
 	if (id < -1 or id > nb_players_) {
-	  cerr << "debug: problem with players in cells." << endl;
+	  _log_error("problem with players in cells.");
 	  return false;
 	}
 	if (players_set.count(id) == 1) {
-	  cerr << "debug: poquemon " << id << " is repeated on board." << endl;
+	  _log_error("poquemon " << id << " is repeated on board.");
 	  return false;
 	}
 	players_set.insert(id);
 	if (poquemons_[id].pos != Pos(i,j)) {
-	  cerr << "debug: wrong position in poquemon " << id << "." << endl;
+	  _log_error("wrong position in poquemon " << id << ".");
 	  return false;
 	}
 	if (not poquemons_[id].alive) {
-	  cerr << "debug: the poquemon " << id << " should be alive." << endl;
+	  _log_error("the poquemon " << id << " should be alive.");
 	  return false;
 	}
       }
@@ -936,7 +953,7 @@ bool Board::ok(void) const {
   for (int id = 0; id < nb_total_poquemon(); ++id) {
     if (players_set.count(id) == 0) {
       if (poquemons_[id].alive) {
-	cerr << "debug: poquemon " << id << " should be dead." << endl;
+	_log_error("poquemon " << id << " should be dead.");
 	return false;
       }
     }
@@ -945,60 +962,60 @@ bool Board::ok(void) const {
   for (int id = 0; id < nb_players_; ++id) {
     const Poquemon& p = poquemons_[id];
     if (p.id != id) {
-      cerr << "debug: poquemon has wrong identifier." << endl;
+      _log_error("poquemon has wrong identifier.");
       return false;
     }
     if (not pos_ok(p.pos)) {
-      cerr << "debug: problem with position of poquemon (1)." << endl;
+      _log_error("problem with position of poquemon (1).");
       return false;
     }
     if (p.attack < 1) {
-      cerr << "debug: invalid attack value." << endl;
+      _log_error("invalid attack value.");
       return false;
     }
     if (p.defense < 1) {
-      cerr << "debug: invalid defense value." << endl;
+      _log_error("invalid defense value.");
       return false;
     }
     if (p.scope < 1 or p.scope > max_scope()) {
-      cerr << "debug: invalid scope value." << endl;
+      _log_error("invalid scope value.");
       return false;
     }
     if (p.points < 0) {
-      cerr << "debug: invalid points value." << endl;
+      _log_error("invalid points value.");
       return false;
     }
     if (p.stones < 0) {
-      cerr << "debug: invalid stone value." << endl;
+      _log_error("invalid stone value.");
       return false;
     }
     if (p.alive and cell(p.pos).id != id) {
-      cerr << "debug: problem with position of poquemon (2)." << endl;
+      _log_error("problem with position of poquemon (2).");
       return false;
     }
     if (p.alive and cell(p.pos).type == Wall) {
-      cerr << "debug: poquemon cannot be in wall." << endl;
+      _log_error("poquemon cannot be in wall.");
       return false;
     }
     if (p.alive and cell(p.pos).type == Stone and p.stones > max_stone()) {
-      cerr << "debug: the player has more stones than maximum allowed." << endl;
+      _log_error("the player has more stones than maximum allowed.");
       return false;
     }
     if (p.alive and cell(p.pos).type == Scope and p.scope > max_scope()) {
-      cerr << "debug: the player has more scope than maximum allowed." << endl;
+      _log_error("the player has more scope than maximum allowed.");
       return false;
     }
 
     if (p.time < 0) {
-      cerr << "debug: regeneration time cannot be negative." << endl;
+      _log_error("regeneration time cannot be negative.");
       return false;
     }
     if (p.time > player_regen_time()) {
-      cerr << "debug: regeneration time cannot exceed max value." << endl;
+      _log_error("regeneration time cannot exceed max value.");
       return false;
     }
     if (p.alive and p.time > 0) {
-      cerr << "debug: live poquemon cannot have non-null regeneration time." << endl;
+      _log_error("live poquemon cannot have non-null regeneration time.");
       return false;
     }
   }
@@ -1006,23 +1023,23 @@ bool Board::ok(void) const {
   for (int k = 0; k < nb_ghost_wall(); ++k) {
     Pos p = ghostWall_[k].pos;
     if (not pos_ok(p)) {
-      cerr << "debug: invalid position of a Ghost Wall." << endl;
+      _log_error("invalid position of a Ghost Wall.");
       return false;
     }
     if (ghostWall_[k].time == 0) {
-      cerr << "debug: regeneration time of ghost wall should be wall_change_time" << endl;
+      _log_error("regeneration time of ghost wall should be wall_change_time");
       return false;
     }
     if (ghostWall_[k].present and cell(p).id != -1) {
-      cerr << "debug: poquemon can't be here." << endl;
+      _log_error("poquemon can't be here.");
       return false;
     }
     if (cell(p).type == Empty and ghostWall_[k].present) {
-      cerr << "debug: problems with cells and Ghost Walls (1)." << endl;
+      _log_error("problems with cells and Ghost Walls (1).");
       return false;
     }
     if (cell(p).type == Wall and not ghostWall_[k].present) {
-      cerr << "debug: problems with cells and Ghost Walls (2)." << endl;
+      _log_error("problems with cells and Ghost Walls (2).");
       return false;
     }
   }
@@ -1030,117 +1047,148 @@ bool Board::ok(void) const {
   for (int k = 0; k < nb_point(); ++k) {
     Pos p = points_[k].pos;
     if (not pos_ok(p)) {
-      cerr << "debug: invalid position of a points bag." << endl;
+      _log_error("invalid position of a points bag.");
       return false;
     }
     if (points_[k].present and points_[k].time > 0) {
-      cerr << "debug: regeneration time of bags should be 0." << endl;
+      _log_error("regeneration time of bags should be 0.");
       return false;
     }
     if (not points_[k].present and points_[k].time == 0) {
-      cerr << "debug: bag should be present." << endl;
+      _log_error("bag should be present.");
       return false;
     }
     if (cell(p).type == Empty and points_[k].present) {
-      cerr << p << endl;
-      cerr << "debug: problems with cells and bags (1)." << endl;
+      _log_error("at " << p);
+      _log_error("problems with cells and bags (1).");
       return false;
     }
     if (cell(p).type == Point and not points_[k].present and points_[k].time == 0) {
-      cerr << "debug: problems with cells and bags (2)." << endl;
+      _log_error("problems with cells and bags (2).");
       return false;
     }
   }	
   for (int k = 0; k < nb_stone(); ++k) {
     Pos p = stones_[k].pos;
     if (not pos_ok(p)) {
-      cerr << p << endl;
-      cerr << "debug: invalid position of a Stone." << endl;
+      _log_error("at " << p);
+      _log_error("invalid position of a Stone.");
       return false;
     }
     if (stones_[k].present and stones_[k].time > 0) {
-      cerr << "debug: regeneration time of stones should be null." << endl;
+      _log_error("regeneration time of stones should be null.");
       return false;
     }
     if (not stones_[k].present and stones_[k].time == 0) {
-      cerr << "debug: stone should be present." << endl;
+      _log_error("stone should be present.");
       return false;
     }
     if (cell(p).type == Empty and stones_[k].present) {
-      cerr << "debug: problems with cells and stones (1)." << endl;
+      _log_error("problems with cells and stones (1).");
       return false;
     }
     if (cell(p).type == Stone and not stones_[k].present and stones_[k].time == 0) {
-      cerr << "debug: problems with cells and stones (2)." << endl;
+      _log_error("problems with cells and stones (2).");
       return false;
     }
   }	
   for (int k = 0; k < nb_scope(); ++k) {
     Pos p = scopes_[k].pos;
     if (not pos_ok(p)) {
-      cerr << "debug: invalid position of a scope bonus." << endl;
+      _log_error("invalid position of a scope bonus.");
       return false;
     }
     if (scopes_[k].present and scopes_[k].time > 0) {
-      cerr << "debug: regeneration time of scope bonus should be null." << endl;
+      _log_error("regeneration time of scope bonus should be null.");
       return false;
     }
     if (not scopes_[k].present and scopes_[k].time == 0) {
-      cerr << "debug: scope bonus should be present." << endl;
+      _log_error("scope bonus should be present.");
       return false;
     }
     if (cell(p).type == Empty and scopes_[k].present) {
-      cerr << "debug: problems with cells and scope bonus (1)." << endl;
+      _log_error("problems with cells and scope bonus (1).");
       return false;
     }
     if (cell(p).type == Scope and not scopes_[k].present and scopes_[k].time == 0) {
-      cerr << "debug: problems with cells and scope bonus (2)." << endl;
+      _log_error("problems with cells and scope bonus (2).");
       return false;
     }
   }
   for (int k = 0; k < nb_attack(); ++k) {
     Pos p = attacks_[k].pos;
     if (not pos_ok(p)) {
-      cerr << "debug: invalid position of an attack bonus." << endl;
+      _log_error("invalid position of an attack bonus.");
       return false;
     }
     if (attacks_[k].present and attacks_[k].time > 0) {
-      cerr << "debug: regeneration time of attacks bonus should be null." << endl;
+      _log_error("regeneration time of attacks bonus should be null.");
       return false;
     }
     if (not attacks_[k].present and attacks_[k].time == 0) {
-      cerr << "debug: attacks bonus should be present." << endl;
+      _log_error("attacks bonus should be present.");
       return false;
     }
     if (cell(p).type == Empty and attacks_[k].present) {
-      cerr << "debug: problems with cells and attacks bonus (1)." << endl;
+      _log_error("problems with cells and attacks bonus (1).");
       return false;
     }
     if (cell(p).type == Attack and not attacks_[k].present and attacks_[k].time == 0) {
-      cerr << "debug: problems with cells and attacks bonus (2)." << endl;
+      _log_error("problems with cells and attacks bonus (2).");
       return false;
     }
   }
   for (int k = 0; k < nb_defense(); ++k) {
     Pos p = defenses_[k].pos;
     if (not pos_ok(p)) {
-      cerr << "debug: invalid position of a defense bonus." << endl;
+      _log_error("invalid position of a defense bonus.");
       return false;
     }
     if (defenses_[k].present and defenses_[k].time > 0) {
-      cerr << "debug: regeneration time of defenses bonus should be null." << endl;
+      _log_error("regeneration time of defenses bonus should be null.");
       return false;
     }
     if (not defenses_[k].present and defenses_[k].time == 0) {
-      cerr << "debug: defense bonus should be present." << endl;
+      _log_error("defense bonus should be present.");
       return false;
     }
     if (cell(p).type == Empty and defenses_[k].present) {
-      cerr << "debug: problems with cells and defenses bonus (1)." << endl;
+      _log_error("problems with cells and defenses bonus (1).");
       return false;
     }
     if (cell(p).type == Defense and not defenses_[k].present and defenses_[k].time == 0) {
-      cerr << "debug: problems with cells and defenses bonus (2)." << endl;
+      _log_error("problems with cells and defenses bonus (2).");
+      return false;
+    }
+  }
+
+  for (int i = 0; i < rows(); ++i)
+    for (int j = 0; j < cols(); ++j) {
+      int w = (cells_[i][j].type == Wall);
+      if (row_walls_[i][j] != (j > 0 ? row_walls_[i][j-1] : 0) + w or
+	  col_walls_[i][j] != (i > 0 ? col_walls_[i-1][j] : 0) + w) {
+	_log_error("visibility index is corrupted.");
+	return false;
+      }
+    }
+
+  if (synced_ == int(changed_.size())) {
+    int nb = 0;
+    for (int i = 0; i < rows(); ++i)
+      for (int j = 0; j < cols(); ++j) {
+	int near = 0;
+	for (int ii = max(i - 2, 0); ii <= min(i + 2, rows() - 1); ++ii)
+	  for (int jj = max(j - 2, 0); jj <= min(j + 2, cols() - 1); ++jj)
+	    near += (cells_[ii][jj].id != -1);
+	bool safe = cells_[i][j].type == Empty and not ghost_[i][j] and near == 0;
+	if (near_[i][j] != near or bool(spawn_ok_[i*cols() + j]) != safe) {
+	  _log_error("spawn index is corrupted.");
+	  return false;
+	}
+	nb += safe;
+      }
+    if (nb != nb_spawn_ok_) {
+      _log_error("spawn index is corrupted.");
       return false;
     }
   }
@@ -1148,77 +1196,176 @@ bool Board::ok(void) const {
   return true;
 }
 
-void Board::hide_opponents(int idPlayer) {
+bool Board::touched_ok(void) const {
 
-  vector<Pos> poquemonPlayer(nb_poquemon());
+  for (const Pos& p : changed_) {
+    const Cell& c = cells_[p.i][p.j];
+    if (c.pos != p) {
+      _log_error("problem with positions in cells.");
+      return false;
+    }
+    int id = c.id;
+    if (id < -1 or id >= nb_total_poquemon()) {
+      _log_error("problem with players in cells.");
+      return false;
+    }
+    if (id != -1) {
+      if (poquemons_[id].pos != p) {
+	_log_error("wrong position in poquemon " << id << ".");
+	return false;
+      }
+      if (not poquemons_[id].alive) {
+	_log_error("the poquemon " << id << " should be alive.");
+	return false;
+      }
+      if (c.type == Wall) {
+	_log_error("poquemon cannot be in wall.");
+	return false;
+      }
+    }
+
+    int near = 0;
+    for (int ii = max(p.i - 2, 0); ii <= min(p.i + 2, rows() - 1); ++ii)
+      for (int jj = max(p.j - 2, 0); jj <= min(p.j + 2, cols() - 1); ++jj)
+	near += (cells_[ii][jj].id != -1);
+    bool safe = c.type == Empty and not ghost_[p.i][p.j] and near == 0;
+    if (near_[p.i][p.j] != near or bool(spawn_ok_[p.i*cols() + p.j]) != safe) {
+      _log_error("spawn index is corrupted.");
+      return false;
+    }
+  }
+
+  for (int id = 0; id < nb_total_poquemon(); ++id) {
+    const Poquemon& pkm = poquemons_[id];
+    if (pkm.alive and cell(pkm.pos).id != id) {
+      _log_error("problem with position of poquemon (2).");
+      return false;
+    }
+    if (pkm.time < 0) {
+      _log_error("regeneration time cannot be negative.");
+      return false;
+    }
+    if (pkm.alive and pkm.time > 0) {
+      _log_error("live poquemon cannot have non-null regeneration time.");
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void Board::hide_opponents(int idPlayer) {
 
   // We take the position of the Poquémon
   // of the player idPlayer.
+  vector<Pos> poquemonPlayer;
   for (int i = 0; i < nb_total_poquemon(); ++i)
     if (poquemon(i).player == idPlayer)
       poquemonPlayer.push_back(poquemon(i).pos);
 
-
-  for (int i = 0; i < rows(); ++i) {
-    for (int j = 0; j < cols(); ++j) {
-      int idCell = cells_[i][j].id;
-      /**
-       * if we find any Poquémon that is not our,
-       * we check if it is visible
-       */
-      if (idCell != -1 and poquemon(idCell).player != idPlayer) {
-	if (not poquemon_visible(poquemonPlayer, Pos(i,j)))
-	  cells_[i][j].id = -1;
-      }
+  /**
+   * For every Poquémon on the board that is not our,
+   * we check if it is visible
+   */
+  for (int i = 0; i < nb_total_poquemon(); ++i) {
+    Pos p = poquemon(i).pos;
+    if (poquemon(i).player != idPlayer and pos_ok(p) and cells_[p.i][p.j].id == i) {
+      if (not poquemon_visible(poquemonPlayer, p))
+	cells_[p.i][p.j].id = -1;
     }
   }
 }
 
-bool Board::poquemon_visible(vector<Pos> poquemonPlayer, Pos p) {
-  bool found = false;
+bool Board::poquemon_visible(const vector<Pos>& poquemonPlayer, Pos p) const {
   for (int i = 0; i < int(poquemonPlayer.size()); ++i)
-    if (poquemonPlayer[i].i == p.i or poquemonPlayer[i].j == p.j) found = true;
-  /**
-   * if we return means that p has not the same raw nor column
-   * with any of the poquemonPlayer's position.
-   */
+    if (is_visible(poquemonPlayer[i], p)) return true;
+  return false;
+}
 
-  if (not found) return false;
-
-  found = false;
-  for (int i = 0; i < int(poquemonPlayer.size()) and not found; ++i) {
-    // same raw
-    if (poquemonPlayer[i].i == p.i) {
-      // p is on the left respect poquemonPlayer[i].
-      if (poquemonPlayer[i].j > p.j)
-	found = is_visible(poquemonPlayer[i], p, Left);
-      // p is on the right respect poquemonPlayer[i].
-      else
-	found = is_visible(poquemonPlayer[i], p, Right);
-    }
-    /**
-     * same column. Else if necessary in case there are more
-     * than one poquemon par player.
-     */
-    else if (poquemonPlayer[i].j == p.j){
-      // p is on the top respect poquemonPlayer[i].
-      if (poquemonPlayer[i].i > p.i)
-	found = is_visible(poquemonPlayer[i], p, Top);
-      // p is on the bottom respect poquemonPlayer[i].
-      else
-	found = is_visible(poquemonPlayer[i], p, Bottom);
+bool Board::is_visible(Pos a, Pos b) const {
+  if (a == b) return false;
+  if (a.i == b.i) {
+    int j1 = min(a.j, b.j), j2 = max(a.j, b.j);
+    return row_walls_[a.i][j2 - 1] == row_walls_[a.i][j1];
+  }
+  if (a.j == b.j) {
+    int i1 = min(a.i, b.i), i2 = max(a.i, b.i);
+    return col_walls_[i2 - 1][a.j] == col_walls_[i1][a.j];
+  }
+  return false;
+}
 
+void Board::init_walls() {
+  row_walls_ = col_walls_ = vector<vector<int> >(rows(), vector<int>(cols()));
+  for (int i = 0; i < rows(); ++i)
+    for (int j = 0; j < cols(); ++j) {
+      int w = (cells_[i][j].type == Wall);
+      row_walls_[i][j] = (j > 0 ? row_walls_[i][j-1] : 0) + w;
+      col_walls_[i][j] = (i > 0 ? col_walls_[i-1][j] : 0) + w;
     }
+}
+
+void Board::update_walls(Pos p) {
+  for (int j = 0; j < cols(); ++j)
+    row_walls_[p.i][j] = (j > 0 ? row_walls_[p.i][j-1] : 0) + (cells_[p.i][j].type == Wall);
+  for (int i = 0; i < rows(); ++i)
+    col_walls_[i][p.j] = (i > 0 ? col_walls_[i-1][p.j] : 0) + (cells_[i][p.j].type == Wall);
+}
+
+void Board::init_spawn() {
+  ghost_ = vector<vector<bool> >(rows(), vector<bool>(cols(), false));
+  for (int k = 0; k < nb_ghost_wall(); ++k)
+    ghost_[ghostWall_[k].pos.i][ghostWall_[k].pos.j] = true;
+  near_ = vector<vector<int> >(rows(), vector<int>(cols(), 0));
+  counted_ = vector<vector<bool> >(rows(), vector<bool>(cols(), false));
+  spawn_ok_ = vector<char>(rows()*cols(), false);
+  spawn_tree_ = vector<int>(rows()*cols() + 1, 0);
+  nb_spawn_ok_ = 0;
+  synced_ = changed_.size();
+  for (int i = 0; i < rows(); ++i)
+    for (int j = 0; j < cols(); ++j)
+      update_spawn(Pos(i, j));
+}
+
+void Board::sync_spawn() {
+  for (; synced_ < int(changed_.size()); ++synced_)
+    update_spawn(changed_[synced_]);
+}
+
+void Board::update_spawn(Pos p) {
+  bool has = (cells_[p.i][p.j].id != -1);
+  if (has != counted_[p.i][p.j]) {
+    counted_[p.i][p.j] = has;
+    for (int i = max(p.i - 2, 0); i <= min(p.i + 2, rows() - 1); ++i)
+      for (int j = max(p.j - 2, 0); j <= min(p.j + 2, cols() - 1); ++j) {
+	near_[i][j] += (has ? 1 : -1);
+	update_spawn_ok(Pos(i, j));
+      }
   }
-  return found;
+  update_spawn_ok(p);
 }
 
-bool Board::is_visible(Pos a, Pos b, Dir d) {
-  while (a != b) {
-    a = a + d;
-    if (a == b) return true;
-    if (cell(a).type == Wall) return false;
+void Board::update_spawn_ok(Pos p) {
+  bool ok = cells_[p.i][p.j].type == Empty and not ghost_[p.i][p.j]
+    and near_[p.i][p.j] == 0;
+  int k = p.i*cols() + p.j;
+  if (ok != bool(spawn_ok_[k])) {
+    spawn_ok_[k] = ok;
+    int d = (ok ? 1 : -1);
+    nb_spawn_ok_ += d;
+    for (int x = k + 1; x < int(spawn_tree_.size()); x += x & -x) spawn_tree_[x] += d;
   }
-  return false;
 }
 
+Pos Board::kth_spawn_position(int k) const {
+  int n = spawn_tree_.size() - 1;
+  int x = 0;
+  int step = 1;
+  while (2*step <= n) step *= 2;
+  for (; step > 0; step /= 2)
+    if (x + step <= n and spawn_tree_[x + step] <= k) {
+      x += step;
+      k -= spawn_tree_[x];
+    }
+  return Pos(x / cols(), x % cols());
+}
@@ -3,6 +3,8 @@
 
 #include "Utils.hh"
 #include "PosDir.hh"
+#include "Writer.hh"
+#include "Check.hh"
 #include "Action.hh"
 
 using namespace std;
@@ -523,6 +525,30 @@ private:
 	vector<double> status_;
 	// cpu status. <-1: dead, 0..1: %of cpu time limit
 
+	// Positions of the cells written while computing this board (maybe repeated).
+	vector<Pos> changed_;
+
+	// Visibility index: for each cell, the number of walls in its row
+	// (column) up to it, both included. Two cells of a row (column) see each
+	// other when no wall lies between them, which is read from these counts.
+	// It only changes when ghost walls toggle.
+	vector<vector<int> > row_walls_;
+	vector<vector<int> > col_walls_;
+
+	// Spawn index: a cell is safe to spawn at when it is empty, it is not
+	// the place of a ghost wall and no Poquémon is at distance 2 or less.
+	// near_ is the number of Poquémon in the 5x5 square centred at each cell,
+	// counted_ whether the Poquémon of each cell (if any) is in near_, and
+	// spawn_tree_ a Fenwick tree over the safe cells in row-major order.
+	// Only the cells in changed_ from synced_ on may be out of date.
+	vector<vector<bool> > ghost_;
+	vector<vector<int> > near_;
+	vector<vector<bool> > counted_;
+	vector<char> spawn_ok_;
+	vector<int> spawn_tree_;
+	int nb_spawn_ok_;
+	int synced_;
+
 	/**
 	 * Construct a board by reading first round from a stream.
 	 */
@@ -534,15 +560,31 @@ private:
 	void print_preamble(ostream& os) const;
 
 	/**
-	 * Print the board to a stream.
+	 * Print the board to a writer.
 	 */
-	void print(ostream& os) const;
+	void print(Writer& os) const;
 
 	/**
-	 * Computes the next board applying the given actions as to the current board.
+	 * Computes into b the next board applying the given actions as to the current board.
 	 * It also returns the actual actions performed.
+	 * b must be a copy of this board or the board this one was computed from,
+	 * so that boards can be used alternately and only changed cells are copied.
 	 */
-	Board next(const vector<Action>& asked, vector<Action>& done) const;
+	void next(const vector<Action>& asked, vector<Action>& done, Board& b) const;
+
+	/**
+	 * Makes this board equal to b, which must have been computed from this one
+	 * (or be equal to it). Settings and names are not copied as they never change.
+	 */
+	void catch_up(const Board& b);
+
+	/**
+	 * Returns the cell at p, noting that it is written.
+	 */
+	inline Cell& cell_priv(const Pos& p) {
+		changed_.push_back(p);
+		return cells_[p.i][p.j];
+	}
 
 	/**
 	 * Applies a Poquémon attack. Returns true if the action can be done.
@@ -559,6 +601,12 @@ private:
 	 */
 	bool ok(void) const;
 
+	/**
+	 * Checks the invariants that concern the cells written while computing
+	 * this board and the Poquémon.
+	 */
+	bool touched_ok(void) const;
+
 	/**
 	 * Returns a reference to the current cpu status of a player.
 	 */
@@ -581,9 +629,10 @@ private:
 	bool exists_objective(Pos p, Dir d, int distMax) const;
 
 	/**
-	 * Returns random safe position to regenerate a bonus
+	 * Returns a random position which is safe to spawn a Poquémon or a bonus,
+	 * or (-1, -1) if there is none.
 	 */
-	Pos get_random_safe_position(CType c, Board& b) const;
+	Pos random_safe_position();
 
 	/**
 	 * Returns the total score of a the player id adding the points
@@ -591,11 +640,6 @@ private:
 	 */
 	int score(int id) const;
 
-	/**
-	 * If position p is a ghost wall it returns true, otherwise false.
-	 */
-	bool is_ghost_wall(Pos p, vector<GhostWall> gw) const;
-
 	/**
 	 * Returns the cell at (i, j).
 	 */
@@ -621,13 +665,50 @@ private:
 	 * Returns if the position (i,j) is visible from any of the
 	 * positions of poquemonPlayer vector.
 	 */
-	bool poquemon_visible(vector<Pos> poquemonPlayer, Pos p);
+	bool poquemon_visible(const vector<Pos>& poquemonPlayer, Pos p) const;
+
+	/**
+	 * Returns true if position b can be seen from position a,
+	 * that is, if they are different cells of the same row or column
+	 * with no wall in between. Otherwise false.
+	 */
+	bool is_visible(Pos a, Pos b) const;
+
+	/**
+	 * Computes the visibility index of the whole board.
+	 */
+	void init_walls();
+
+	/**
+	 * Recomputes the visibility index of the row and the column of p,
+	 * after its cell has become or stopped being a wall.
+	 */
+	void update_walls(Pos p);
+
+	/**
+	 * Computes the spawn index of the whole board.
+	 */
+	void init_spawn();
+
+	/**
+	 * Brings the spawn index up to date with the cells written so far.
+	 */
+	void sync_spawn();
+
+	/**
+	 * Updates the spawn index after the contents of the cell at p have changed.
+	 */
+	void update_spawn(Pos p);
+
+	/**
+	 * Updates whether p is safe to spawn at, keeping the other cells.
+	 */
+	void update_spawn_ok(Pos p);
 
 	/**
-	 * Returns true if position b can be seen from position a
-	 * going through direction d. Otherwise false.
+	 * Returns the k-th (from 0) cell which is safe to spawn at, in row-major order.
 	 */
-	bool is_visible(Pos a, Pos b, Dir d);
+	Pos kth_spawn_position(int k) const;
 
 	void srandomize(int s);
 
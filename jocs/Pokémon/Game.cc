@@ -6,39 +6,45 @@ using namespace std;
 
 
 void Game::run (vector<string> names, istream& is, ostream& os, int seed) {
-  cerr << "info: loading game" << endl;
+  _log_info("loading game");
   Board b0(is);
-  cerr << "info: loaded game" << endl;
+  _log_info("loaded game");
 
   b0.srandomize(seed);
 
   if (int(names.size()) != b0.nb_players()) {
-    cerr << "fatal: wrong number of players." << endl;
+    _log_error("wrong number of players.");
     exit(EXIT_FAILURE);
   }
 
   vector<Player*> players;        
   for (int player = 0; player < b0.nb_players(); ++player) {
     string name = names[player];
-    cerr << "info: loading player " << name << endl;
+    _log_info("loading player " << name);
     players.push_back(Registry::new_player(name));
     players[player]->srandomize(seed + player);
     b0.names_[player] = name;
   }
-  cerr << "info: players loaded" << endl;
+  _log_info("players loaded");
 
   os << "Game" << endl << endl;  
   os << "Seed " << seed << endl << endl;
-  b0.print_preamble(os);
-  b0.print(os);
+  // Each round is formatted into w and written to os in one go.
+  Writer w;
+  b0.print_preamble(w);
+  b0.print(w);
+  w.write_to(os);
 
+  // b0 is the current board and b1 the one where the next is computed.
+  Board b1 = b0;
   for (int round = 0; round < b0.nb_rounds(); ++round) {
-    cerr << "info: start round " << round << endl;
-    os << "actions_asked" << endl;
-    os << "player action direction" << endl;
+    _log_info("start round " << round);
+    w << "actions_asked" << endl;
+    w << "player action direction" << endl;
     vector<Action> asked;
     for (int player = 0; player < b0.nb_players(); ++player) {
-      cerr << "info:     start player " << player << endl;
+      _log_info("    start player " << player);
+      Log::flush(); // the player may write to stderr too
       Action a;
       int s = players[player]->randomize();
       players[player]->reset(player, b0, a);
@@ -47,29 +53,32 @@ void Game::run (vector<string> names, istream& is, ostream& os, int seed) {
       players[player]->play();
       asked.push_back(*players[player]);
 
-      os << player << " ";
-      Action(*players[player]).print(os);
-      cerr << "info:     end player " << player << endl;
+      w << player << " ";
+      Action(*players[player]).print(w);
+      _log_info("    end player " << player);
     }
     vector<Action> done(b0.nb_players());
-    cerr << "start next" << endl;
-    Board b1 = b0.next(asked, done);
-    cerr << "end next" << endl;
+    _log_debug("start next");
+    b0.next(asked, done, b1);
+    _log_debug("end next");
 
-    os << endl << "actions_done" << endl;
-    os << "player action direction" << endl;
+    w << endl << "actions_done" << endl;
+    w << "player action direction" << endl;
     for (int player = 0; player < b0.nb_players(); ++player) {
-      os << player << " ";
-      done[player].print(os);
+      w << player << " ";
+      done[player].print(w);
     }
-    os << endl;
+    w << endl;
 
-    b1.print(os);
+    b1.print(w);
+    w.write_to(os);
     b1.srandomize(b0.randomize());
-    b0 = b1;
-    cerr << "info: end round " << round << endl;
+    swap(b0, b1);
+    _log_info("end round " << round);
   }
 
+  // Results are always printed, after any pending log messages.
+  Log::flush();
   vector<int> max_players;
   int max_score = minint;
 
@@ -87,5 +96,5 @@ void Game::run (vector<string> names, istream& is, ostream& os, int seed) {
     cerr << " " << b0.name(max_players[k]);
   cerr << " got top score" << endl;
 
-  cerr << "info: game played" << endl;
+  _log_info("game played");
 }
@@ -19,6 +19,7 @@
 #include <sys/resource.h>
 
 #include "BackTrace.hh"
+#include "Log.hh"
 
 using namespace std;
 
@@ -30,7 +31,7 @@ using namespace std;
  * (somehow adapted from err.h and error.h)
  */
 
-#define myerror_at_line(status, error, file, line, ...) { fprintf(stderr, "Error at %s:%i: ", file, line); fprintf(stderr, __VA_ARGS__); if (error) perror(" errno"); fprintf(stderr, "\n"); exit(status); }
+#define myerror_at_line(status, error, file, line, ...) { Log::flush(); fprintf(stderr, "Error at %s:%i: ", file, line); fprintf(stderr, __VA_ARGS__); if (error) perror(" errno"); fprintf(stderr, "\n"); exit(status); }
 #define myerr(...) myerror_at_line(EXIT_FAILURE, errno, __FILE__, __LINE__, __VA_ARGS__)
 #define myerrx(...) myerror_at_line(EXIT_FAILURE, 0, __FILE__, __LINE__, __VA_ARGS__)
 
@@ -0,0 +1,231 @@
+#include "Board.hh"
+#include "Action.hh"
+#include "Defs.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+using namespace std;
+
+
+/** \file
+ * Times Board::next and Board::move_starship on the given maps, one line
+ * per map:
+ *
+ *   ./Bench [-g games] [-r runs] map1.cnf map2.cnf ...
+ *
+ * Every map is played games times (with seeds 1, 2, ...), as in
+ * Game::run, and all of it is repeated runs times (5 by default). Each
+ * round, before next(), every alive starship is moved with
+ * move_starship(), in turn in each of the 9 directions, and these moves
+ * are timed on their own. next() gets no instructions, and it is timed
+ * on its own too. For each map it prints the mean number of missiles in
+ * flight, the mean and worst time of next(), and the mean time of a
+ * move_starship() call, each the median of the runs. The cost of reading
+ * the clock is measured once and subtracted from every measure.
+ *
+ *   ./Bench --dense-missiles rows cols spacing > missiles.cnf
+ *
+ * writes instead a universe with a missile every spacing columns in all
+ * its rows but the first 4, where the starships are, to see that a round
+ * keeps a steady cost with thousands of missiles in flight. Each row
+ * ends with a wider gap, so that its missiles are not blocked. "make
+ * bench" builds missiles.cnf with 60 rows, 400 columns and spacing 2
+ * (11144 missiles).
+ */
+
+
+int seed = 1; // Printed by Board::print_settings(), as in Main.cc.
+
+
+class Bench {
+
+public:
+
+  static void run (const string& file, int games, int runs, double clock_ns);
+
+  static void dense_missiles (int rows, int cols, int spacing, ostream& os);
+
+};
+
+
+void Bench::dense_missiles (int rows, int cols, int spacing, ostream& os) {
+  os << "starwar v1"          << endl
+     << "secgame ?"           << endl
+     << "seed ?"              << endl
+     << "nb_players 4"        << endl
+     << "nb_rnds 200"         << endl
+     << "nb_rows "            << rows << endl
+     << "nb_uni_cols "        << cols << endl
+     << "nb_win_cols 31"      << endl
+     << "nb_ships_x_player 1" << endl
+     << "nb_rnds_regen 50"    << endl
+     << "nb_miss_bonuses 0"   << endl
+     << "nb_point_bonuses 0"  << endl
+     << "bonus_miss 5"        << endl
+     << "bonus_pnts 10"       << endl
+     << "kill_pnts 30"        << endl
+     << "names ? ? ? ?"       << endl << endl
+     << "rnd 0"               << endl << endl;
+
+  os << "   ";
+  for (int j = 0; j < cols; ++j) os << (j / 10) % 10;
+  os << endl << "   ";
+  for (int j = 0; j < cols; ++j) os << j % 10;
+  os << endl;
+  for (int i = 0; i < rows; ++i)
+    os << (i / 10) << (i % 10) << " " << string(cols, '.') << endl;
+
+  os << endl << "starships" << endl << "sid row column nb_miss alive time" << endl;
+  for (int k = 0; k < 4; ++k) os << k << " " << k << " 30 0 y 0" << endl;
+
+  int per_row = (cols - 1) / spacing; // Columns 0, spacing, ... below cols - spacing.
+  os << endl << "missiles" << endl << (rows - 4)*per_row << endl
+     << "mid sid row column" << endl;
+  int mid = 0;
+  for (int i = 4; i < rows; ++i)
+    for (int j = 0; j < cols - spacing; j += spacing)
+      os << mid++ << " 0 " << i << " " << j << endl;
+
+  os << endl << "players" << endl << "pid score status" << endl;
+  for (int p = 0; p < 4; ++p) os << p << " 0 0" << endl;
+}
+
+
+typedef chrono::steady_clock Clock;
+
+
+/**
+ * Returns the mean time in ns of a measure that does nothing: two
+ * consecutive readings of the clock.
+ */
+double clock_cost () {
+  const int N = 1000000;
+  double total = 0;
+  for (int k = 0; k < N; ++k) {
+    Clock::time_point start = Clock::now();
+    total += chrono::duration<double, nano>(Clock::now() - start).count();
+  }
+  return total/N;
+}
+
+
+/**
+ * Returns the median of v.
+ */
+double median (vector<double> v) {
+  sort(v.begin(), v.end());
+  int n = v.size();
+  return n%2 ? v[n/2] : (v[n/2 - 1] + v[n/2])/2;
+}
+
+
+void Bench::run (const string& file, int games, int runs, double clock_ns) {
+  ifstream ifs(file.c_str());
+  my_assert(ifs);
+  ostringstream oss;
+  oss << ifs.rdbuf();
+
+  const Dir dirs[] = {
+    SLOW_UP, UP, FAST_UP, SLOW, DEFAULT, FAST, SLOW_DOWN, DOWN, FAST_DOWN
+  };
+
+  long long rounds = 0;
+  vector<double> missiles, round_us, worst_us, move_ns;
+  for (int r = 0; r < runs; ++r) {
+    rounds = 0;
+    long long moves = 0;
+    long long miss  = 0;
+    double next_total = 0;
+    double next_worst = 0;
+    double move_total = 0;
+    for (int g = 0; g < games; ++g) {
+      istringstream is(oss.str());
+      Board b(is);
+      b.srandomize(g + 1);
+      for (int round = 0; round < b.number_rounds(); ++round) {
+        int n = 0;
+        Clock::time_point start = Clock::now();
+        for (Starship& s : b.ships)
+          if (s.alive) {
+            b.move_starship(s, dirs[(s.sid + round)%9]);
+            ++n;
+          }
+        double ns = chrono::duration<double, nano>(Clock::now() - start).count();
+        if (n > 0) {
+          move_total += ns - clock_ns;
+          moves += n;
+        }
+        // As at the end of next(), missiles killed by these moves go away.
+        b.miss.erase(remove_if(b.miss.begin(), b.miss.end(),
+                               [](const Missile& m) { return m.sid == -1; }),
+                     b.miss.end());
+
+        miss += b.miss.size();
+        vector<Action> asked(b.number_players());
+        vector<Action> done(b.number_players());
+        start = Clock::now();
+        b.next(asked, done);
+        double us = (chrono::duration<double, nano>(Clock::now() - start).count() - clock_ns)/1000;
+        next_total += us;
+        next_worst = max(next_worst, us);
+        ++rounds;
+      }
+    }
+    missiles.push_back(double(miss)/rounds);
+    round_us.push_back(next_total/rounds);
+    worst_us.push_back(next_worst);
+    move_ns.push_back(move_total/max(moves, 1LL));
+  }
+
+  cout << setw(14) << left << file << right << fixed << setprecision(1)
+       << setw(8)  << rounds
+       << setw(10) << median(missiles)
+       << setw(12) << median(round_us)
+       << setw(12) << median(worst_us)
+       << setw(10) << median(move_ns) << endl;
+}
+
+
+int main (int argc, char** argv) {
+  if (argc == 5 and string(argv[1]) == "--dense-missiles") {
+    int rows    = atoi(argv[2]);
+    int cols    = atoi(argv[3]);
+    int spacing = atoi(argv[4]);
+    if (rows < 10 or rows > 100 or cols < 31 or spacing < 2 or spacing >= cols) {
+      cerr << "Wrong universe: rows in [10, 100], cols >= 31, spacing in [2, cols)." << endl;
+      return EXIT_FAILURE;
+    }
+    Bench::dense_missiles(rows, cols, spacing, cout);
+    return EXIT_SUCCESS;
+  }
+
+  int games = 1;
+  int runs  = 5;
+  int k = 1;
+  while (k + 1 < argc and (string(argv[k]) == "-g" or string(argv[k]) == "-r")) {
+    (string(argv[k]) == "-g" ? games : runs) = atoi(argv[k + 1]);
+    k += 2;
+  }
+  if (k == argc or games <= 0 or runs <= 0) {
+    cout << "Usage: " << argv[0] << " [-g games] [-r runs] map1.cnf map2.cnf ..." << endl;
+    cout << "       " << argv[0] << " --dense-missiles rows cols spacing" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // The invariant checks are not part of what is measured.
+  Check::set_period(0);
+
+  double clock_ns = clock_cost();
+
+  cout << LONG_GAME_NAME << " v" << VERSION << ": time of Board::next and Board::move_starship"
+       << " (median of " << runs << " runs)" << endl;
+  cout << setw(14) << left << "map" << right
+       << setw(8)  << "rounds"
+       << setw(10) << "missiles"
+       << setw(12) << "us/round"
+       << setw(12) << "worst us"
+       << setw(10) << "ns/move" << endl;
+  for (; k < argc; ++k) Bench::run(argv[k], games, runs, clock_ns);
+}
@@ -94,11 +94,12 @@ Board::Board (istream& is) {
   is >> s;
   is >> s;
 
-  cells = vector< vector<Cell> >(number_rows(), vector<Cell>(number_universe_columns()));
+  cells = vector<Cell>(number_rows()*number_universe_columns());
 
   // The map shows empty cells, asteroids and bonuses.
   // Starships and missiles are not drawn on the map but listed later.
 
+  nb_miss_bonuses_on_board = nb_point_bonuses_on_board = 0;
   for (int i = 0; i < number_rows(); ++i) {
 
     // Reading auxiliary row label.
@@ -111,8 +112,8 @@ Board::Board (istream& is) {
       switch (c) {
       case '.': cellPriv({i, j}).type = EMPTY;         break;
       case 'X': cellPriv({i, j}).type = ASTEROID;      break;
-      case 'P': cellPriv({i, j}).type = POINT_BONUS;   break;
-      case 'M': cellPriv({i, j}).type = MISSILE_BONUS; break;
+      case 'P': cellPriv({i, j}).type = POINT_BONUS;   ++nb_point_bonuses_on_board; break;
+      case 'M': cellPriv({i, j}).type = MISSILE_BONUS; ++nb_miss_bonuses_on_board;  break;
       default:  my_assert(false);
       }
     }
@@ -177,13 +178,18 @@ Board::Board (istream& is) {
 
     j = normalize(j);
     
+    my_assert(mid >= 0);
     my_assert(starship_ok(sid));
     my_assert(within_universe({i, j}));
     my_assert(cellPriv({i, j}).type == EMPTY);
 
-    miss[mid] = {mid, sid, {i, j}};
+    miss.push_back({mid, sid, {i, j}});
     cellPriv({i, j}) = {MISSILE, -1, mid};
   }
+  sort(miss.begin(), miss.end(), [](const Missile& a, const Missile& b) { return a.mid < b.mid; });
+  for (int k = 1; k < n_missiles; ++k)
+    my_assert(miss[k-1].mid < miss[k].mid);
+  fresh_mid = miss.empty() ? 0 : miss.back().mid + 1;
 
 
   is >> s;
@@ -239,21 +245,21 @@ void Board::print_settings(ostream& os, bool secgame) const {
 }
 
 
-void Board::print_state(ostream& os) const {
+void Board::print_state(Writer& os) const {
 
-  os << endl;
-  os << "rnd " << round() << endl << endl;
+  os << '\n';
+  os << "rnd " << round() << "\n\n";
 
 
   // Printing auxiliary lines labelling columns.
   os << "   ";
   for (int j = 0; j < number_universe_columns(); ++j) os << (j / 10);
-  os << endl;
+  os << '\n';
 
   os << "   ";
   for (int j = 0; j < number_universe_columns(); ++j) os << (j % 10);
-  os << endl;
-  os << endl;
+  os << '\n';
+  os << '\n';
 
   for (int i = 0; i < number_rows(); ++i) {
     os << (i / 10) << (i % 10) << " "; // Printing column labels.
@@ -266,19 +272,19 @@ void Board::print_state(ostream& os) const {
       default:             os << '.'; break;
       };
     }
-    os << endl;
+    os << '\n';
   }
-  os << endl << endl;
+  os << "\n\n";
 
 
 
-  os << "starships" << endl;
+  os << "starships" << '\n';
   os << "sid"      << "\t"
      << "row"     << "\t"
      << "column"  << "\t"
      << "nb_miss" << "\t"
      << "alive"   << "\t"
-     << "time"    << endl;
+     << "time"    << '\n';
 
   for (const Starship& s: ships)
     os << s.sid                    << "\t"
@@ -286,72 +292,55 @@ void Board::print_state(ostream& os) const {
        << normalize(second(s.pos)) << "\t"
        << s.nb_miss                << "\t"
        << (s.alive ? 'y' : 'n')    << "\t"
-       << s.time                   << endl;
-  os << endl;
+       << s.time                   << '\n';
+  os << '\n';
 
 
 
-  os << "missiles"  << endl;
-  os << miss.size() << endl;
+  os << "missiles"  << '\n';
+  os << miss.size() << '\n';  // There are no killed missiles between rounds.
   os << "mid"       << "\t"
      << "sid"       << "\t"
      << "row"       << "\t"
-     << "column"    << endl;
+     << "column"    << '\n';
 
-  for (const auto& x: miss) {
-    const Missile& m = x.second;
+  for (const Missile& m: miss) {
     os << m.mid                    << "\t"
        << m.sid                    << "\t"
        << first( m.pos)            << "\t"
-       << normalize(second(m.pos)) << endl;
+       << normalize(second(m.pos)) << '\n';
   }
-  os << endl;
+  os << '\n';
 
 
 
-  os << "players" << endl;
+  os << "players" << '\n';
   os << "pid"     << "\t"
      << "score"   << "\t"
-     << "status"  << endl;
+     << "status"  << '\n';
 
   for (Player_Id p = 0; p < number_players(); ++p)
     os << p         << "\t"
        << score(p)  << "\t"
-       << status(p) << endl;
+       << status(p) << '\n';
 
-  os << endl;
+  os << '\n';
 }
 
 
-Board Board::next (const vector<Action>& asked, vector<Action>& done) {
-
-  assert(ok());
-
-  // b will be the new board we shall return.
-  Board b = *this;
+void Board::next (const vector<Action>& asked, vector<Action>& done) {
 
   // Increment the round.
-  ++b.rnd;
+  ++rnd;
 
   // Move missiles.
-  queue<Missile> q;
-  for (const auto& x : b.miss)
-    q.push(x.second);
+  move_missiles();
 
-  // Missiles should move continuously and at the same time,
-  // but we move them discretely. We process them in a way
-  // that they never crash with each other.
-  while (not q.empty()) {
-    Missile m = q.front();
-    q.pop();
-    if (b.cellPriv(m.pos + DEFAULT).type != MISSILE and
-        b.cellPriv(m.pos +    FAST).type != MISSILE)
-      b.move_missile(b.miss[m.mid]);
-    else q.push(m);
-  }
-
-  // Sort players randomly.
+  // Sort players randomly. The rest of the round draws from the generator
+  // as it was before, and the next round is seeded from this one.
+  Random_generator sorter = rgen;
   vector<int> random_players = random_permutation(number_players());
+  swap(rgen, sorter);
 
   // Handle commands of each player.
   vector<bool> commanded(number_starships(), false);
@@ -367,41 +356,55 @@ Board Board::next (const vector<Action>& asked, vector<Action>& done) {
 	      ))
 	continue;
 
-      if (b.ships[ins.sid].alive and b.apply(ins)) {
+      if (ships[ins.sid].alive and apply(ins)) {
 	commanded[ins.sid] = true;
 	done[p].sids.insert(ins.sid);
 	done[p].instructs.push_back(ins);
       }
     }
     for (Starship_Id s = begin(p); s != end(p); ++s)
-      if (not commanded[s] and b.ships[s].alive)
-        b.apply({s, MOVE, DEFAULT});
+      if (not commanded[s] and ships[s].alive)
+        apply({s, MOVE, DEFAULT});
   }
 
   // Regenerate starships.
-  for (Starship& s : b.ships)
+  for (Starship& s : ships)
     if (not s.alive) {
-      if (s.time == 0) b.regenerate_starship(s);
+      if (s.time == 0) regenerate_starship(s);
       else --s.time;
     }
 
   // Place new bonuses.
-  int nb_miss_bonuses_to_place  = nb_miss_bonuses;
-  int nb_point_bonuses_to_place = nb_point_bonuses;
-  for (int i = 0; i < number_rows(); ++i)
-    for (int j = 0; j < number_universe_columns(); ++j) {
-      if      (b.cellPriv({i, j}).type == MISSILE_BONUS) --nb_miss_bonuses_to_place;
-      else if (b.cellPriv({i, j}).type == POINT_BONUS  ) --nb_point_bonuses_to_place;
-    }
+  int nb_miss_bonuses_to_place  = nb_miss_bonuses  - nb_miss_bonuses_on_board;
+  int nb_point_bonuses_to_place = nb_point_bonuses - nb_point_bonuses_on_board;
 
-  while (nb_miss_bonuses_to_place  > 0 and b.place_new_bonus(MISSILE_BONUS))
+  while (nb_miss_bonuses_to_place  > 0 and place_new_bonus(MISSILE_BONUS))
     --nb_miss_bonuses_to_place;
 
-  while (nb_point_bonuses_to_place > 0 and b.place_new_bonus(POINT_BONUS))
+  while (nb_point_bonuses_to_place > 0 and place_new_bonus(POINT_BONUS))
     --nb_point_bonuses_to_place;
 
-  assert(b.ok());
-  return b;
+  // Remove killed missiles.
+  miss.erase(remove_if(miss.begin(), miss.end(), [](const Missile& m) { return m.sid == -1; }),
+             miss.end());
+
+  rgen.srandomize(sorter.randomize());
+
+  if (Check::full(round())) {
+    my_assert(ok());
+  }
+  else if (Check::enabled()) {
+    my_assert(touched_ok());
+  }
+  touched.clear();
+}
+
+
+Missile& Board::missile(Missile_Id mid) {
+  auto it = lower_bound(miss.begin(), miss.end(), mid,
+                        [](const Missile& m, Missile_Id id) { return m.mid < id; });
+  my_assert(it != miss.end() and it->mid == mid and it->sid != -1);
+  return *it;
 }
 
 
@@ -416,25 +419,33 @@ bool Board::move_starship(Starship& s, Dir dir) {
 
   if (dir == SLOW) return true;
 
-  const auto& all = dir2all.at(dir);
-  my_assert(not all.empty());
-  for (Dir d : all) {
-    my_assert(d != Dir(0, 0));
-    Cell& c = cellPriv(s.pos + d);
+  int i = first(s.pos);
+  int j = second(s.pos);
+
+  // Moves the starship to the cell at offset (di, dj).
+  auto advance = [&](int di, int dj) {
+    touch(cell_index(i + di, j + dj)) = {STARSHIP, s.sid, -1};
+    touch(cell_index(i,      j     )) = {EMPTY,       -1, -1};
+    s.pos = {i + di, wrap(j + dj)};
+  };
+
+  const Dir_path& path = dir_paths[dir_index(dir)];
+  my_assert(path.n > 0);
+  for (int k = 0; k < path.n; ++k) {
+    int di = path.di[k];
+    int dj = path.dj[k];
+    my_assert(di != 0 or dj != 0);
+    Cell& c = cells[cell_index(i + di, j + dj)];
     if (c.type == POINT_BONUS) {
       scores[player_of(s.sid)] += bonus_points();
-      c.type = EMPTY;
+      clear(c);
     }
     else if (c.type == MISSILE_BONUS) {
       s.nb_miss += bonus_missiles();
-      c.type = EMPTY;
+      clear(c);
     }
     else if (c.type == ASTEROID) {
-
-      cellPriv(s.pos + d) = {STARSHIP, s.sid, -1};
-      cellPriv(s.pos    ) = {EMPTY,       -1, -1};
-      s.pos += d;
-      s.pos.imag(normalize(s.pos.imag()));
+      advance(di, dj);
       kill_starship(s);
 
       c.type = EMPTY;
@@ -444,36 +455,25 @@ bool Board::move_starship(Starship& s, Dir dir) {
       Starship& t = ships[c.sid];
       my_assert(s.sid != t.sid);
 
-      cellPriv(s.pos + d) = {STARSHIP, s.sid, -1};
-      cellPriv(s.pos    ) = {EMPTY,       -1, -1};
-      s.pos += d;
-      s.pos.imag(normalize(s.pos.imag()));
+      advance(di, dj);
       kill_starship(s);
 
       kill_starship(t);
       return true;
     }
     else if (c.type == MISSILE) {
-      my_assert(miss.contains(c.mid));
-      Missile m = miss[c.mid];
+      Missile& m = missile(c.mid);
       if (player_of(m.sid) != player_of(s.sid))
         scores[player_of(m.sid)] += kill_points();
 
-      cellPriv(s.pos + d) = {STARSHIP, s.sid, -1};
-      cellPriv(s.pos    ) = {EMPTY,       -1, -1};
-      s.pos += d;
-      s.pos.imag(normalize(s.pos.imag()));
+      advance(di, dj);
       kill_starship(s);
 
       kill_missile(m);
       return true;
     }
   }
-  cellPriv(s.pos + dir) = {STARSHIP, s.sid, -1};
-  cellPriv(s.pos      ) = {EMPTY,       -1, -1};
-
-  s.pos += dir;
-  s.pos.imag(normalize(s.pos.imag()));
+  advance(first(dir), second(dir));
   
   return true;
 }
@@ -489,10 +489,9 @@ bool Board::shoot(Starship& s) {
   if (s.nb_miss > 0) {
     --s.nb_miss;
     Missile_Id mid = new_missile_identifier();
-    my_assert(not miss.contains(mid));
-    miss[mid] = {mid, s.sid, s.pos};
-    move_missile(miss[mid]);
-    cellPriv(s.pos) = {STARSHIP, s.sid, -1 }; // Correcting.
+    miss.push_back({mid, s.sid, s.pos});
+    move_missile(miss.back());
+    touch(s.pos) = {STARSHIP, s.sid, -1 }; // Correcting.
     return true;
   }
   else return false;
@@ -501,17 +500,20 @@ bool Board::shoot(Starship& s) {
 
 bool Board::move_missile(Missile& m) {
 
-  const auto& all = dir2all.at(FAST);
-  my_assert(not all.empty());
-  for (Dir d : all) {
-    my_assert(d != Dir(0, 0));
-    Cell& c = cellPriv(m.pos + d);
+  int i = first(m.pos);
+  int j = second(m.pos);
+
+  const Dir_path& path = dir_paths[dir_index(FAST)];
+  my_assert(path.n > 0);
+  for (int k = 0; k < path.n; ++k) {
+    my_assert(path.di[k] != 0 or path.dj[k] != 0);
+    Cell& c = cells[cell_index(i + path.di[k], j + path.dj[k])];
     my_assert(c.type != MISSILE);
     if (c.type == POINT_BONUS   or
         c.type == MISSILE_BONUS or
         c.type == ASTEROID) {
       kill_missile(m);
-      c.type = EMPTY;
+      clear(c);
       return true;
     }
     else if (c.type == STARSHIP) {
@@ -523,16 +525,56 @@ bool Board::move_missile(Missile& m) {
       return true;
     }
   }
-  cellPriv(m.pos + FAST) = {MISSILE, -1, m.mid};
-  cellPriv(m.pos)        = {EMPTY,   -1, -1   };
+  touch(cell_index(i + first(FAST), j + second(FAST))) = {MISSILE, -1, m.mid};
+  touch(cell_index(i,               j               )) = {EMPTY,   -1, -1   };
 
-  m.pos += FAST;
-  m.pos.imag(normalize(m.pos.imag()));
+  m.pos = {i + first(FAST), wrap(j + second(FAST))};
   
   return true;
 }
 
 
+void Board::move_missiles() {
+
+  // Missiles should move continuously and at the same time,
+  // but we move them discretely. We process them in a way
+  // that they never crash with each other: a missile only
+  // interacts with the cells in the two columns ahead of it,
+  // so in each row we move it after the missiles in front.
+
+  // Missiles of each row, by column.
+  vector< vector<int> > lane(number_rows());
+  for (int k = 0; k < int(miss.size()); ++k)
+    lane[first(miss[k].pos)].push_back(k);
+
+  int u = number_universe_columns();
+  for (vector<int>& l : lane) {
+    int n = l.size();
+    if (n == 0) continue;
+    sort(l.begin(), l.end(), [&](int a, int b) {
+      return second(miss[a].pos) < second(miss[b].pos);
+    });
+    auto col = [&](int x) { return second(miss[l[x]].pos); };
+
+    // The row is cylindrical: start from a missile with no other
+    // missile right ahead, and go backwards from there.
+    int g = n - 1;
+    while (g >= 0 and (g + 1 < n ? col(g + 1) : col(0) + u) - col(g) < 3) --g;
+    if (g < 0) {
+      // Every missile is blocked by the next one around the row.
+      _log_warning("missiles blocked in row " << first(miss[l[0]].pos));
+      continue;
+    }
+    for (int t = 0; t < n; ++t) {
+      Missile& m = miss[l[(g - t + n) % n]];
+      my_assert(cellPriv(m.pos + DEFAULT).type != MISSILE);
+      my_assert(cellPriv(m.pos +    FAST).type != MISSILE);
+      move_missile(m);
+    }
+  }
+}
+
+
 bool Board::place_new_bonus(CType bonus) {
   my_assert(bonus == POINT_BONUS or bonus == MISSILE_BONUS);
   Pos p;
@@ -540,8 +582,10 @@ bool Board::place_new_bonus(CType bonus) {
   int f = number_rows();
   int cu = number_universe_columns();
   int cw = number_window_columns();
-  if (random_empty_position({0, r+cw}, {f-1, r+cu-1}, 5, {MISSILE, STARSHIP}, p)) {
-    cellPriv(p) = {bonus, -1, -1};
+  if (random_empty_position({0, r+cw}, {f-1, r+cu-1}, 5, type_set(MISSILE) | type_set(STARSHIP), p)) {
+    touch(p) = {bonus, -1, -1};
+    if (bonus == MISSILE_BONUS) ++nb_miss_bonuses_on_board;
+    else                        ++nb_point_bonuses_on_board;
     return true;
   }
   else return false;
@@ -553,18 +597,19 @@ bool Board::regenerate_starship(Starship& s) {
   int r = round();
   int f = number_rows();
   int c = number_window_columns();
-  if (random_empty_position({0, r}, {f-1, r+c-1}, 5, {MISSILE, STARSHIP, ASTEROID}, p)) {
+  if (random_empty_position({0, r}, {f-1, r+c-1}, 5,
+                            type_set(MISSILE) | type_set(STARSHIP) | type_set(ASTEROID), p)) {
     s.pos = p;
     s.alive = true;
     s.time = 0;
-    cellPriv(p) = {STARSHIP, s.sid, -1};
+    touch(p) = {STARSHIP, s.sid, -1};
     return true;
   }
   else return false;
 }
 
 
-bool Board::random_empty_position(Pos up_left, Pos down_right, int n, const set<CType>& s, Pos& p) {
+bool Board::random_empty_position(Pos up_left, Pos down_right, int n, CTypeSet s, Pos& p) {
   const int MAX_ATTEMPS = 20;
   for (int k = 0; k < MAX_ATTEMPS; ++k) {
     int i = randomize( first(up_left),  first(down_right));
@@ -578,113 +623,106 @@ bool Board::random_empty_position(Pos up_left, Pos down_right, int n, const set<
 }
 
 
-bool Board::is_free(Pos p, int n, const set<CType>& s) {
+bool Board::is_free(Pos p, int n, CTypeSet s) {
   my_assert(n % 2 == 1);
-  for (int i = first(p) - n/2; i <= first(p) + n/2; ++i)
-    for (int j = second(p) - n/2; j <= second(p) + n/2; ++j) {
-      Pos q = {i, j};
-      if (within_universe(q)) {
-        CType t = cellPriv(q).type;
-        if (s.contains(t)) return false;
-      }
-    }
+  my_assert(n <= number_universe_columns());
+  int j0 = normalize(second(p));
+  for (int i = max(first(p) - n/2, 0); i <= min(first(p) + n/2, number_rows() - 1); ++i)
+    for (int j = j0 - n/2; j <= j0 + n/2; ++j)
+      if (s & type_set(cells[cell_index(i, j)].type)) return false;
   return true;
 }
 
 
 void Board::kill_starship(Starship& s) {
   my_assert(s.alive);
-  cellPriv(s.pos) = {EMPTY, -1, -1};
+  touch(s.pos) = {EMPTY, -1, -1};
   s.alive = false;
   s.time = number_rounds_to_regenerate();
 }
 
 
 void Board::kill_missile(Missile& m) {
-  cellPriv(m.pos) = {EMPTY, -1, -1};
-  miss.erase(m.mid);
+  touch(m.pos) = {EMPTY, -1, -1};
+  m.sid = -1;
 }
 
 
 bool Board::ok() const {
 
   if (not(nb_players == 4)) {
-    cerr << "debug: problems with parameter setting (0)." << endl;
+    _log_error("problems with parameter setting (0).");
     return false;
   }
   if (not(nb_rnds >= 1)) {
-    cerr << "debug: problems with parameter setting (1)." << endl;
+    _log_error("problems with parameter setting (1).");
     return false;
   }
   if (not(nb_rows >= 10)) {
-    cerr << "debug: problems with parameter setting (2)." << endl;
+    _log_error("problems with parameter setting (2).");
     return false;
   }
   if (not(nb_uni_cols >= 10)) {
-    cerr << "debug: problems with parameter setting (3)." << endl;
+    _log_error("problems with parameter setting (3).");
     return false;
   }
   if (not(nb_win_cols >= 10)) {
-    cerr << "debug: problems with parameter setting (4)." << endl;
+    _log_error("problems with parameter setting (4).");
     return false;
   }
   if (not(nb_win_cols <= nb_uni_cols)) {
-    cerr << "debug: problems with parameter setting (5)." << endl;
+    _log_error("problems with parameter setting (5).");
     return false;
   }
   if (not(nb_ships_x_player >= 1)) {
-    cerr << "debug: problems with parameter setting (6)." << endl;
+    _log_error("problems with parameter setting (6).");
     return false;
   }
   if (not(nb_rnds_regen >= 1)) {
-    cerr << "debug: problems with parameter setting (7)." << endl;
+    _log_error("problems with parameter setting (7).");
     return false;
   }
   if (not(nb_miss_bonuses >= 0)) {
-    cerr << "debug: problems with parameter setting (8)." << endl;
+    _log_error("problems with parameter setting (8).");
     return false;
   }
   if (not(nb_point_bonuses >= 0)) {
-    cerr << "debug: problems with parameter setting (9)." << endl;
+    _log_error("problems with parameter setting (9).");
     return false;
   }
   if (not(bonus_miss >= 0)) {
-    cerr << "debug: problems with parameter setting (10)." << endl;
+    _log_error("problems with parameter setting (10).");
     return false;
   }
   if (not(bonus_pnts >= 0)) {
-    cerr << "debug: problems with parameter setting (11)." << endl;
+    _log_error("problems with parameter setting (11).");
     return false;
   }
   if (not(kill_pnts >= 0)) {
-    cerr << "debug: problems with parameter setting (12)." << endl;
+    _log_error("problems with parameter setting (12).");
     return false;
   }
   if (not(rnd >= 0)) {
-    cerr << "debug: problems with number of rounds (1)." << endl;
+    _log_error("problems with number of rounds (1).");
     return false;
   }
   if (not(rnd <= nb_rnds)) {
-    cerr << "debug: problems with number of rounds (2)." << endl;
+    _log_error("problems with number of rounds (2).");
     return false;
   }
 
-  if (int(cells.size()) != number_rows()) {
-    cerr << "debug: problems with row dimension of the board." << endl;
-    return false;
-  }
-  if (int(cells[0].size()) != number_universe_columns()) {
-    cerr << "debug: problems with column dimension of the board." << endl;
+  if (int(cells.size()) != number_rows()*number_universe_columns()) {
+    _log_error("problems with dimensions of the board.");
     return false;
   }
 
   if (int(names.size()) != number_players()) {
-    cerr << "debug: problems with number of players and names." << endl;
+    _log_error("problems with number of players and names.");
     return false;
   }
   for (const string& s : names)
     if (s == "") {
-      cerr << "debug: names cannot be empty." << endl;
+      _log_error("names cannot be empty.");
       return false;
     }
 
@@ -694,59 +732,62 @@ bool Board::ok() const {
   for (int i = 0; i < number_rows(); ++i) {
     for (int j = 0; j < number_universe_columns(); ++j) {
 
-      int sid = cells[i][j].sid;
+      const Cell& c = cells[cell_index(i, j)];
+      int sid = c.sid;
       if (sid < -1 or sid > number_starships()) {
-        cerr << "debug: problem with starship identifiers in cells." << endl;
+        _log_error("problem with starship identifiers in cells.");
         return false;
       }
-      if (sid == -1 and cells[i][j].type == STARSHIP) {
-        cerr << "debug: cell should have a valid starship identifier." << endl;
+      if (sid == -1 and c.type == STARSHIP) {
+        _log_error("cell should have a valid starship identifier.");
         return false;
       }
-      if (sid != -1 and cells[i][j].type != STARSHIP) {
-        cerr << "debug: cell should have an invalid starship identifier." << endl;
+      if (sid != -1 and c.type != STARSHIP) {
+        _log_error("cell should have an invalid starship identifier.");
         return false;
       }
       
-      int mid = cells[i][j].mid;
+      int mid = c.mid;
       if (mid < -1) {
-        cerr << "debug: problem with missile identifiers in cells." << endl;
+        _log_error("problem with missile identifiers in cells.");
         return false;
       }
-      if (mid == -1 and cells[i][j].type == MISSILE) {
-        cerr << "debug: cell should have a valid missile identifier." << endl;
+      if (mid == -1 and c.type == MISSILE) {
+        _log_error("cell should have a valid missile identifier.");
         return false;
       }
-      if (mid != -1 and cells[i][j].type != MISSILE) {
-        cerr << "debug: cell should have an invalid missile identifier." << endl;
+      if (mid != -1 and c.type != MISSILE) {
+        _log_error("cell should have an invalid missile identifier.");
         return false;
       }
-      if (cells[i][j].type == MISSILE and not miss.contains(mid)) {
-        cerr << "debug: missile map is corrupted." << endl;
+      if (c.type == MISSILE and
+          not binary_search(miss.begin(), miss.end(), Missile{mid, -1, {0, 0}},
+                            [](const Missile& a, const Missile& b) { return a.mid < b.mid; })) {
+        _log_error("missile map is corrupted.");
         return false;
       }
       
-      if      (cells[i][j].type == MISSILE_BONUS) ++nb_miss_bonuses_on_board;
-      else if (cells[i][j].type == POINT_BONUS)   ++nb_point_bonuses_on_board;
-      else if (cells[i][j].type == STARSHIP)      ++nb_ships_on_board[player_of(sid)];
+      if      (c.type == MISSILE_BONUS) ++nb_miss_bonuses_on_board;
+      else if (c.type == POINT_BONUS)   ++nb_point_bonuses_on_board;
+      else if (c.type == STARSHIP)      ++nb_ships_on_board[player_of(sid)];
     }
   }
-  if (nb_miss_bonuses_on_board > nb_miss_bonuses) {
-    cerr << "debug: problems with the number of missile bonuses" << endl;
-    return false;
-  }
-  if (nb_point_bonuses_on_board > nb_point_bonuses) {
-    cerr << "debug: problems with the number of point bonuses" << endl;
+  if (nb_miss_bonuses_on_board != this->nb_miss_bonuses_on_board or
+      nb_point_bonuses_on_board != this->nb_point_bonuses_on_board) {
+    _log_error("bonus counters are corrupted");
     return false;
   }
+  // There can be more bonuses than nb_miss_bonuses and nb_point_bonuses
+  // if the map starts with more (as maze4.cnf does): new bonuses are only
+  // placed while there are fewer.
   for (int n : nb_ships_on_board)
     if (n > number_starships_per_player()) {
-      cerr << "debug: problems with the number of starships" << endl;
+      _log_error("problems with the number of starships");
       return false;
     }
 
   if (int(ships.size()) != number_starships()) {
-      cerr << "debug: problems with the size of ships" << endl;
+      _log_error("problems with the size of ships");
       return false;
   }
 
@@ -754,71 +795,126 @@ bool Board::ok() const {
   for (int k = 0; k < int(ships.size()); ++k) {
     const Starship& s = ships[k];
     if (k != s.sid) {
-      cerr << "debug: ships is in an inconsistent state" << endl;
+      _log_error("ships is in an inconsistent state");
       return false;
     }
     Player_Id p = player_of(s.sid);
     if (s.alive) {
       ++alive[p];
       if (cell(s.pos).type != STARSHIP) {
-        cerr << "debug: problems with the correspondence between cells and ships" << endl;
+        _log_error("problems with the correspondence between cells and ships");
         return false;
       }
     }
     if (s.nb_miss < 0) {
-      cerr << "debug: number of available missiles cannot be negative" << endl;
+      _log_error("number of available missiles cannot be negative");
       return false;
     }
     if (s.time < 0) {
-      cerr << "debug: time cannot be negative" << endl;
+      _log_error("time cannot be negative");
       return false;
     }
     if (s.alive and s.time > 0) {
-      cerr << "debug: found inconsistency between alive and time" << endl;
+      _log_error("found inconsistency between alive and time");
       return false;
     }
   }
   for (Player_Id p = 0; p < number_players(); ++p)
     if (nb_ships_on_board[p] != alive[p]) {
-      cerr << "debug: problems with the number of alive ships" << endl;
+      _log_error("problems with the number of alive ships");
       return false;
     }
 
-  for (const auto& x : miss) {
-    const Missile& m = x.second;
-    if (x.first != m.mid) {
-      cerr << "debug: miss is in an inconsistent state" << endl;
+  for (int k = 0; k < int(miss.size()); ++k) {
+    const Missile& m = miss[k];
+    if (k > 0 and not(miss[k-1].mid < m.mid)) {
+      _log_error("miss is in an inconsistent state");
+      return false;
+    }
+    if (m.mid >= fresh_mid) {
+      _log_error("missile has an unused identifier");
       return false;
     }
     if (not starship_ok(m.sid)) {
-      cerr << "debug: missile has an invalid starship identifier" << endl;
+      _log_error("missile has an invalid starship identifier");
       return false;
     }
     if (cell(m.pos).type != MISSILE) {
-      cerr << "debug: problems with the correspondence between cells and missiles" << endl;
+      _log_error("problems with the correspondence between cells and missiles");
       return false;
     }
   }
 
   if (int(scores.size()) != number_players()) {
-    cerr << "debug: problems with number of players and scores." << endl;
+    _log_error("problems with number of players and scores.");
     return false;
   }
   for (int s : scores)
     if (s < 0) {
-      cerr << "debug: there cannot be negative scores." << endl;
+      _log_error("there cannot be negative scores.");
       return false;
     }
 
   if (int(statuses.size()) != number_players()) {
-    cerr << "debug: problems with number of players and status." << endl;
+    _log_error("problems with number of players and status.");
     return false;
   }
   for (int s : statuses)
     if (s != -1 and not(0 <= s and s <= 1)) {
-      cerr << "debug: problems with the status." << endl;
+      _log_error("problems with the status.");
       return false;
     }
 
   return true;
 }
+
+
+bool Board::touched_ok() const {
+
+  for (int k : touched) {
+    const Cell& c = cells[k];
+    Pos p = {k / nb_uni_cols, k % nb_uni_cols};
+
+    if (c.type == STARSHIP) {
+      if (not starship_ok(c.sid) or c.mid != -1) {
+        _log_error("cell should have a valid starship identifier.");
+        return false;
+      }
+      const Starship& s = ships[c.sid];
+      if (not s.alive or s.pos != p) {
+        _log_error("problems with the correspondence between cells and ships");
+        return false;
+      }
+    }
+    else if (c.sid != -1) {
+      _log_error("cell should have an invalid starship identifier.");
+      return false;
+    }
+
+    if (c.type == MISSILE) {
+      auto it = lower_bound(miss.begin(), miss.end(), c.mid,
+                            [](const Missile& m, Missile_Id id) { return m.mid < id; });
+      if (it == miss.end() or it->mid != c.mid or it->pos != p) {
+        _log_error("problems with the correspondence between cells and missiles");
+        return false;
+      }
+    }
+    else if (c.mid != -1) {
+      _log_error("cell should have an invalid missile identifier.");
+      return false;
+    }
+  }
+
+  for (const Starship& s : ships) {
+    if (s.alive and (cell(s.pos).type != STARSHIP or cell(s.pos).sid != s.sid)) {
+      _log_error("problems with the correspondence between cells and ships");
+      return false;
+    }
+    if (s.nb_miss < 0 or s.time < 0 or (s.alive and s.time > 0)) {
+      _log_error("starship " << s.sid << " is in an inconsistent state");
+      return false;
+    }
+  }
+
+  return true;
+}
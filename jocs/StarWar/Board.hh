@@ -3,6 +3,8 @@
 
 #include "Utils.hh"
 #include "Action.hh"
+#include "Writer.hh"
+#include "Check.hh"
 
 using namespace std;
 
@@ -20,6 +22,17 @@ enum CType {
 };
 
 
+/**
+ * A set of cell types, as a bitmask.
+ */
+
+typedef unsigned CTypeSet;
+
+inline constexpr CTypeSet type_set(CType t) {
+  return 1u << t;
+}
+
+
 /**
  * Printing function for CType.
  */
@@ -272,6 +285,7 @@ private:
   // Allow access to the private part of Board.
   friend class Game;
   friend class SecGame;
+  friend class Bench;
 
   Random_generator rgen;
 
@@ -297,12 +311,27 @@ private:
   // Game state
   int rnd;
 
-  vector< vector<Cell> >    cells;
+  // The universe is cylindrical: cell (i, j) is stored at
+  // i*nb_uni_cols + (j mod nb_uni_cols), so the window slides
+  // along it without moving any cell.
+  vector<Cell>              cells;
   vector<Starship>          ships;
-  map<Missile_Id, Missile>  miss;
   vector<int>               scores;
   vector<double>            statuses;
 
+  // Missiles, by increasing identifier. Identifiers are given in increasing
+  // order, so new missiles go at the end. Killed missiles get sid = -1 and are
+  // removed at the end of the round, so there are none between rounds.
+  vector<Missile>           miss;
+  Missile_Id                fresh_mid;
+
+  // Number of bonuses of each kind on the board.
+  int                       nb_miss_bonuses_on_board;
+  int                       nb_point_bonuses_on_board;
+
+  // Indices in cells of the cells changed in this round (maybe repeated).
+  vector<int>               touched;
+
 
   /**
    * Construct a board by reading from a stream.
@@ -315,6 +344,39 @@ private:
    */
   Cell& cellPriv(const Pos& p);
 
+  /**
+   * Returns j mod nb_uni_cols, for -nb_uni_cols <= j < 2*nb_uni_cols.
+   */
+  int wrap(int j) const {
+    if      (j <  0)           return j + nb_uni_cols;
+    else if (j >= nb_uni_cols) return j - nb_uni_cols;
+    else                       return j;
+  }
+
+  /**
+   * Returns the index in cells of the cell at row i and column j,
+   * for -nb_uni_cols <= j < 2*nb_uni_cols.
+   */
+  int cell_index(int i, int j) const {
+    return i*nb_uni_cols + wrap(j);
+  }
+
+  /**
+   * Returns the cell with index k, noting that it changes in this round.
+   */
+  Cell& touch(int k) {
+    touched.push_back(k);
+    return cells[k];
+  }
+
+  /**
+   * Returns the cell at position p, noting that it changes in this round.
+   */
+  Cell& touch(const Pos& p) {
+    my_assert(within_universe(p));
+    return touch(first(p)*nb_uni_cols + normalize(second(p)));
+  }
+
 
   /**
    * Print the board settings to a stream.
@@ -323,15 +385,25 @@ private:
 
 
   /**
-   * Print the board state to a stream.
+   * Print the board state to a writer.
+   */
+  void print_state(Writer& os) const;
+
+  /**
+   * Advances the board to the next round after applying the given actions.
+   * It also returns the actual actions performed.
+   */
+  void next(const vector<Action>& asked, vector<Action>& done);
+
+  /**
+   * Returns the alive missile with identifier mid.
    */
-  void print_state(ostream& os) const;
+  Missile& missile(Missile_Id mid);
 
   /**
-   * Computes the next board after applying the given actions to the
-   * current board. It also returns the actual actions performed.
+   * Empties a cell with an asteroid or a bonus, keeping count of the bonuses.
    */
-  Board next(const vector<Action>& asked, vector<Action>& done);
+  void clear(Cell& c);
 
   /**
    * Applies an instruction.
@@ -357,6 +429,11 @@ private:
    */
   bool move_missile(Missile& m);
 
+  /**
+   * Moves all the missiles, each of them once.
+   */
+  void move_missiles();
+
   /**
    * Places a new bonus at a random position.
    * Returns true if successful.
@@ -374,13 +451,13 @@ private:
    * of size n x n not containing cells of any type in s.
    * Returns true if successful.
    */
-  bool random_empty_position(Pos up_left, Pos down_right, int n, const set<CType>& s, Pos& p);
+  bool random_empty_position(Pos up_left, Pos down_right, int n, CTypeSet s, Pos& p);
 
   /**
    * Returns whether all cells within a square ball of size n x n centered at p
    * do not contain cells of any type in s.
    */
-  bool is_free(Pos p, int n, const set<CType>& s);
+  bool is_free(Pos p, int n, CTypeSet s);
   
   /**
    * Kills a starship.
@@ -395,12 +472,17 @@ private:
   /**
    * Returns a new missile identifier.
    */
-  Missile_Id new_missile_identifier() const;
+  Missile_Id new_missile_identifier();
   
   /**
    * Asserts invariants of the board. For debugging.
    */
   bool ok() const;
+
+  /**
+   * Asserts the invariants that concern the touched cells and the starships.
+   */
+  bool touched_ok() const;
   
   // Returns a random permutation of {0, 1, ..., n-1}.
   vector<int> random_permutation(int n);
@@ -553,16 +635,12 @@ inline int Board::round() const {
 
 inline Cell Board::cell(const Pos& p) const {
   my_assert(within_universe(p));
-  int i = first(p);
-  int j = normalize(second(p));
-  return cells[i][j];
+  return cells[first(p)*nb_uni_cols + normalize(second(p))];
 }
 
 inline Cell& Board::cellPriv(const Pos& p) {
   my_assert(within_universe(p));
-  int i = first(p);
-  int j = normalize(second(p));  
-  return cells[i][j];
+  return cells[first(p)*nb_uni_cols + normalize(second(p))];
 }
 
 inline Starship Board::starship(Starship_Id s) const {
@@ -571,7 +649,10 @@ inline Starship Board::starship(Starship_Id s) const {
 }
 
 inline map<Missile_Id, Missile> Board::missiles() const {
-  return miss;
+  map<Missile_Id, Missile> res;
+  for (const Missile& m : miss)
+    if (m.sid != -1) res.emplace_hint(res.end(), m.mid, m);
+  return res;
 }
 
 inline int Board::score(Player_Id p) const{
@@ -600,9 +681,15 @@ inline bool Board::apply(const Instruction& ins) {
   }
 }
 
-inline Missile_Id Board::new_missile_identifier() const {
-  static int cnt = 0;
-  return cnt++;
+inline Missile_Id Board::new_missile_identifier() {
+  return fresh_mid++;
+}
+
+inline void Board::clear(Cell& c) {
+  if      (c.type == MISSILE_BONUS) --nb_miss_bonuses_on_board;
+  else if (c.type == POINT_BONUS  ) --nb_point_bonuses_on_board;
+  c.type = EMPTY;
+  touched.push_back(&c - &cells[0]);
 }
 
 inline vector<int> Board::random_permutation(int n) {
@@ -15,6 +15,8 @@ void help (int argc, char** argv) {
   cout << "--input=file          -i input     set input file  (default: stdin)"  << endl;
   cout << "--output=file         -o output    set output file (default: stdout)" << endl;
   cout << "--list                -l           list registered players"           << endl;
+  cout << "--quiet               -q           only log warnings and errors"      << endl;
+  cout << "--check=n             -c n         check the board every n rounds (default: 1, never: 0)"      << endl;
   cout << "--version             -v           print version"                     << endl;
   cout << "--help                -h           print help"                        << endl;
 }
@@ -39,6 +41,8 @@ int main (int argc, char** argv) {
         {"input",          required_argument,  0, 'i'},
         {"output",         required_argument,  0, 'o'},
         {"list",           no_argument,        0, 'l'},
+        {"quiet",          no_argument,        0, 'q'},
+        {"check",          required_argument,  0, 'c'},
         {"version",        no_argument,        0, 'v'},
         {"help",           no_argument,        0, 'h'},
         {0, 0, 0, 0}
@@ -53,7 +57,7 @@ int main (int argc, char** argv) {
         int option_index = 0;
         int c = getopt_long(
             argc, argv,
-            "s:i:o:lvh",
+            "s:i:o:lqc:vh",
             long_options, &option_index
         );
 
@@ -77,6 +81,17 @@ int main (int argc, char** argv) {
                 Registry::print_players(cout);
                 return EXIT_SUCCESS;
 
+            case 'q':
+                Log::set_level(LOG_WARNING);
+                break;
+
+            case 'c': {
+                int period = atoi(optarg);
+                my_assert(period >= 0);
+                Check::set_period(period);
+                break;
+            }
+
             case 'v':
                 version();
                 return EXIT_SUCCESS;
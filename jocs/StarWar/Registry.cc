@@ -20,7 +20,7 @@ int Registry::Register (const char* name, Factory factory) {
 Player* Registry::new_player (string name) {
     dict::iterator it = reg->find(name);
     if (it == reg->end()) {
-      cerr << "error: player " << name << " not registered." << endl;
+      _log_error("player " << name << " not registered.");
       my_assert(false);
     }
     Factory f = it->second;
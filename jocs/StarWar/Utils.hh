@@ -81,6 +81,30 @@ struct Cmp {
 };
 
 extern const map<Dir, vector<Dir>, Cmp> dir2all;
+
+// Offsets of the cells that a move goes through, in the order in which they
+// are checked, the last one being its destination. Same as dir2all, as a
+// table that needs no lookup.
+struct Dir_path {
+  int n;
+  int di[5];
+  int dj[5];
+};
+
+constexpr Dir_path dir_paths[9] = {
+  { 1, {-1,  0,  0,  0,  0}, { 0,  0,  0,  0,  0} },  // SLOW_UP
+  { 3, { 0, -1, -1,  0,  0}, { 1,  0,  1,  0,  0} },  // UP
+  { 5, { 0, -1, -1,  0, -1}, { 1,  0,  1,  2,  2} },  // FAST_UP
+  { 1, { 0,  0,  0,  0,  0}, { 0,  0,  0,  0,  0} },  // SLOW
+  { 1, { 0,  0,  0,  0,  0}, { 1,  0,  0,  0,  0} },  // DEFAULT
+  { 2, { 0,  0,  0,  0,  0}, { 1,  2,  0,  0,  0} },  // FAST
+  { 1, { 1,  0,  0,  0,  0}, { 0,  0,  0,  0,  0} },  // SLOW_DOWN
+  { 3, { 0,  1,  1,  0,  0}, { 1,  0,  1,  0,  0} },  // DOWN
+  { 5, { 0,  1,  1,  0,  1}, { 1,  0,  1,  2,  2} }   // FAST_DOWN
+};
+
+// Index of a direction in dir_paths.
+inline int dir_index(Dir d) { return 3*(first(d) + 1) + second(d); }
   
 /////////////////// random numbers //////////////////////
 
@@ -97,6 +121,8 @@ extern const map<Dir, vector<Dir>, Cmp> dir2all;
 #include <cerrno>
 #include <time.h>
 
+#include "Log.hh"
+
 
 class Random_generator {
 
@@ -146,6 +172,7 @@ public:
 
 #define my_assert(X)                                                              \
   if (not (X)) {							\
+       Log::flush();                                                               \
        cerr << "Failed assertion '" << #X << "' in file "			  \
                                     << __FILE__ << ", line " << __LINE__ << "\n"; \
        exit(1);                                                                   \
@@ -46,9 +46,9 @@ struct PLAYER_NAME : public Player {
 
     
     // Write debugging info about barricades
-    vector<Pos> bs = barricades(me());
+    const set<Pos>& bs = barricade_positions(me());
     cerr << "At round " << round() << " player " << me() << " has " << bs.size() << " barricades:" << endl;
-    for (Pos& p : bs) {
+    for (const Pos& p : bs) {
       Cell c = cell(p);
       cerr << "Pos " << p << " with resistance " << c.resistance << endl;
     }
@@ -57,7 +57,7 @@ struct PLAYER_NAME : public Player {
     if (is_day()) {
       
       // At day take care of builders
-      vector<int> b = builders(me());
+      const set<int>& b = builder_ids(me());
       for (int id : b) { // Iterate over all builders
 	Pos p = citizen(id).pos;
 
@@ -99,7 +99,7 @@ struct PLAYER_NAME : public Player {
     }
     else {
       // At night take care of warriors
-      vector<int> w = warriors(me());
+      const set<int>& w = warrior_ids(me());
       for (int id : w) { // Iterate over all warriors
 	if (random(0,9) < 6) {// 60 % probability move randomly, otherwise do nothing
 	  Dir random_dir = dirs[random(0,3)];
@@ -18,7 +18,7 @@ Action::Action (istream& is) {
       v.push_back(Command(i, char2CommandType(c), char2Dir(d)));
     }
     else {
-      //cerr << "warning: only partially read command for citizen " << i << endl;
+      //_log_warning("only partially read command for citizen " << i);
       return;
     }
   }
@@ -2,6 +2,9 @@
 
 #include "Board.hh"
 #include "Action.hh"
+
+#include <thread>
+#include <unistd.h>
   
 void Board::create_new_citizen(Pos p, CitizenType t, int pl) {
   int id = fresh_id;
@@ -9,10 +12,13 @@ void Board::create_new_citizen(Pos p, CitizenType t, int pl) {
   _my_assert(not citizens.count(id), "Identifier is not fresh.");
 
   citizens[id] = Citizen(t, id, pl, p, (t == Builder ? NoWeapon : Hammer), citizen_ini_life(t));
+  if (id >= int(citizen_by_id.size())) citizen_by_id.resize(id + 1, nullptr);
+  citizen_by_id[id] = &citizens[id];
 
   _my_assert(grid[p.i][p.j].is_empty(),        "Cell is already full.");
 
   grid[p.i][p.j].id = id;
+  update_regen_near(p, 1);
 
   if      (t == Builder) player2builders[pl].insert(id);
   else                  player2warriors [pl].insert(id);
@@ -34,11 +40,20 @@ Board::Board(istream& is, int seed) {
   rnd = 0;
   day = true;
 
+  bonus_to_regenerate    = Timer_wheel<BonusType>(max(num_rounds_regen_food(), num_rounds_regen_money()));
+  weapons_to_regenerate  = Timer_wheel<WeaponType>(num_rounds_regen_weapon());
+  citizens_to_regenerate = Timer_wheel<pair<CitizenType,int>>(max(num_rounds_regen_builder(), num_rounds_regen_warrior()));
+
   fresh_id = 0;
   read_generator_and_grid(is);
+  init_regen_index();
 
   for (auto& p : citizens) fresh_id = max(fresh_id,p.first);
   ++fresh_id;
+
+  citizen_by_id = vector<Citizen*>(fresh_id, nullptr);
+  for (auto& p : citizens) citizen_by_id[p.first] = &p.second;
+  touched.clear();
   
   _my_assert(ok(), "Invariants are not satisfied.");
 }
@@ -153,22 +168,22 @@ void Board::print_names (ostream& os) const {
 }
 
 
-void Board::print_state (ostream& os) {
+void Board::print_state (Writer& os) {
 
   // Should start with the same format of Info::read_grid.
   // Then other data describing the state.
 
-  os << endl << endl;
+  os << "\n\n";
 
   os << "   ";
   for (int j = 0; j < board_cols(); ++j)
     os << j / 10;
-  os << endl;
+  os << '\n';
 
   os << "   ";
   for (int j = 0; j < board_cols(); ++j)
     os << j % 10;
-  os << endl;
+  os << '\n';
 
   for (int i = 0; i < board_rows(); ++i) {
     os << i / 10 << i % 10 << " ";
@@ -181,23 +196,23 @@ void Board::print_state (ostream& os) {
       else if (c.bonus  == Food)     os << 'F';
       else if (c.id     != -1) {
 	if (c.resistance == -1) {
-	  if (citizens[c.id].type == Builder) os << 'C'; // builder without barricade
+	  if (citizen_by_id[c.id]->type == Builder) os << 'C'; // builder without barricade
 	  else                                os << 'W'; // warrior without barricade
 	}
 	else {
-	  if (citizens[c.id].type == Builder) os << 'c'; // buider with barricade
+	  if (citizen_by_id[c.id]->type == Builder) os << 'c'; // buider with barricade
 	  else                                os << 'w'; // warrior with barricade
 	}
       }
       else if (c.resistance != -1) os << 'b'; // barricade with no citizen
       else                           os << '.';
     }
-    os << endl;
+    os << '\n';
   }
 
-  os << endl << "citizens" << endl;
-  os << citizens.size() << endl;
-  os << "type\tid\tplayer\trow\tcolumn\tweapon\tlife" << endl;
+  os << '\n' << "citizens" << '\n';
+  os << citizens.size() << '\n';
+  os << "type\tid\tplayer\trow\tcolumn\tweapon\tlife" << '\n';
   for (const auto& ci : citizens) {
     os << CitizenType2char(ci.second.type) << "\t";
     os << ci.second.id << "\t";
@@ -205,41 +220,41 @@ void Board::print_state (ostream& os) {
     os << ci.second.pos.i << "\t";
     os << ci.second.pos.j << "\t";
     os << WeaponType2char(ci.second.weapon) << "\t";
-    os << ci.second.life << endl;
+    os << ci.second.life << '\n';
   }
 
-  os << endl << "barricades" << endl;
+  os << '\n' << "barricades" << '\n';
   // Collect them
   vector<Pos> barricades;
   for (int i = 0; i < board_rows(); ++i)
     for (int j = 0; j < board_cols(); ++j)
       if (grid[i][j].resistance != -1) barricades.push_back(Pos(i,j));
-  os << barricades.size() << endl;
-  os << "player\trow\tcolumn\tresistance" << endl;
+  os << barricades.size() << '\n';
+  os << "player\trow\tcolumn\tresistance" << '\n';
   for (const auto& p : barricades) {
     os << grid[p.i][p.j].b_owner << "\t";
     os << p.i << "\t";
     os << p.j << "\t";
-    os << grid[p.i][p.j].resistance << endl;
+    os << grid[p.i][p.j].resistance << '\n';
   }
 
-  os << endl;
+  os << '\n';
 
-  os << "round " << rnd << endl;
-  os << "day " << day << endl;
-  os << endl;
+  os << "round " << rnd << '\n';
+  os << "day " << day << '\n';
+  os << '\n';
 
   os << "score";
   for (auto s : scr) os << "\t" << s;
-  os << endl;
+  os << '\n';
 
-  os << endl;
+  os << '\n';
 
   os << "status";
   for (auto s : stats) os << "\t" << s;
-  os << endl;
+  os << '\n';
 
-  os << endl;
+  os << '\n';
 }
 
 
@@ -273,47 +288,42 @@ bool Board::first_citizen_wins_attack (const Citizen& c1, const Citizen& c2) {
   return num < threshold;
 }
 
-void Board::perform_attack (Citizen& ci, Citizen& ci2, set<int>& killed, vector<pair<pair<CitizenType,int>,int>>& citizens_to_regenerate) {
+void Board::perform_attack (Citizen& ci, Citizen& ci2) {
   bool first_wins = first_citizen_wins_attack(ci,ci2);
   Citizen& winner = (first_wins ? ci  : ci2);
   Citizen& loser =  (first_wins ? ci2 : ci );
 
   loser.life -= life_lost_in_attack();
   if (loser.life <= 0) { // Dead!!!
-    kill(loser.id,killed);
-    citizens_to_regenerate.push_back({{loser.type,loser.player},num_rounds_regen_citizen(loser.type)});
+    kill(loser.id);
+    citizens_to_regenerate.add({loser.type,loser.player},num_rounds_regen_citizen(loser.type));
     if (loser.type == Builder)  scr[winner.player] += kill_builder_points();
     else                        scr[winner.player] += kill_warrior_points();
   }
 }      
 
-bool Board::execute(const Command&    m,
-                    set<int>&         killed,
-		    vector<pair<BonusType,int>>&   bonus_to_regenerate,
-		    vector<pair<WeaponType,int>>&  weapon_to_regenerate,
-		    vector<pair<pair<CitizenType,int>,int>>& citizens_to_regenerate
-		    ) {
+bool Board::execute(const Command&    m) {
 
   int         id     =                  m.id;
   Dir         dir    =            Dir(m.dir);
   CommandType c_type = CommandType(m.c_type);
   
   if (not command_type_ok(c_type)) {
-    //cerr << "warning: invalid command type in command: " << c_type << endl;
+    //_log_warning("invalid command type in command: " << c_type);
     return false;
   }
 
-  if (killed.count(id)) return false; // Citizen has been killed in this round
+  Citizen* cip = find_citizen(id);
+  if (cip == nullptr) return false; // Citizen has been killed in this round
 
-  
-  Citizen&      ci = citizens[id];
+  Citizen&      ci = *cip;
   CitizenType type = ci.type;    
   int           pl = ci.player;
   Pos           op = ci.pos;
   Cell&         oc = grid[op.i][op.j];
 
   if (not dir_ok(dir)) {
-    //cerr << "warning: invalid dir in command: " << dir << endl;
+    //_log_warning("invalid dir in command: " << dir);
     return false;
   }
   
@@ -321,46 +331,38 @@ bool Board::execute(const Command&    m,
 
     Pos np = op + dir;
     if (not pos_ok(np)) {
-      //cerr << "warning: cannot move to position " << np << " out of the board." << endl;
+      //_log_warning("cannot move to position " << np << " out of the board.");
       return false;
     }
 
     Cell& nc = grid[np.i][np.j];
     if (nc.type == Building) {
-      //cerr << "warning: cannot move to position " << np << " with a building." << endl;
+      //_log_warning("cannot move to position " << np << " with a building.");
       return false;
     }
     else if (nc.bonus == Food) { // Take food and move
-      bonus_to_regenerate.push_back({nc.bonus,num_rounds_regen_food()});
+      bonus_to_regenerate.add(nc.bonus,num_rounds_regen_food());
       nc.bonus = NoBonus;
-      nc.id = id;
-      oc.id = -1;
-      ci.pos = np;
+      move_citizen(ci, np);
       ci.life = min(ci.life + food_incr_life(), citizen_ini_life(type));
     }
     else if (nc.bonus == Money) { // Take money and move
-      bonus_to_regenerate.push_back({nc.bonus,num_rounds_regen_money()});
+      bonus_to_regenerate.add(nc.bonus,num_rounds_regen_money());
       nc.bonus = NoBonus;
-      nc.id = id;
-      oc.id = -1;
-      ci.pos = np;
+      move_citizen(ci, np);
       scr[pl] += money_points();
     }
     else if (nc.weapon != NoWeapon) {
       if (type == Builder) { // Moves and weapon disappears	
-	weapon_to_regenerate.push_back({nc.weapon,num_rounds_regen_weapon()});
+	weapons_to_regenerate.add(nc.weapon,num_rounds_regen_weapon());
 	nc.weapon = NoWeapon;
-	nc.id = id;
-	oc.id = -1;
-	ci.pos = np;	
+	move_citizen(ci, np);
       }
       else { // Warrior: moves and takes strongest weapon. Weapon disappears
-	weapon_to_regenerate.push_back({nc.weapon,num_rounds_regen_weapon()});
+	weapons_to_regenerate.add(nc.weapon,num_rounds_regen_weapon());
 	ci.weapon = strongestWeapon(ci.weapon,nc.weapon);
 	nc.weapon = NoWeapon;
-	nc.id = id;
-	oc.id = -1;
-	ci.pos = np;	
+	move_citizen(ci, np);
       }
     }
     else if (nc.resistance != -1) { // Barricade
@@ -368,9 +370,7 @@ bool Board::execute(const Command&    m,
 	if      (nc.id != -1)      return false; // Also citizen: not attack to rivals, do not step on friends
 	else if (nc.b_owner != pl) return false; // No citizen and barricade of another rival at day
 	else {  // Same clan free barricade : moves there
-	  nc.id = id;
-	  oc.id = -1;
-	  ci.pos = np;
+	  move_citizen(ci, np);
 	}
       }
       else { // night
@@ -380,67 +380,64 @@ bool Board::execute(const Command&    m,
 	    player2barricades[nc.b_owner].erase(np);
 	    nc.resistance = -1;
 	    nc.b_owner = -1;
+	    cell_changed(np);
 	  }	  
 	}
 	else { // own barricade
 	  if (nc.id != -1) return false; // occupied --> ignore move
 	  else { // free --> move there
-	    nc.id = id;
-	    oc.id = -1;
-	    ci.pos = np;	   
+	    move_citizen(ci, np);
 	  }
 	}
       }
     }
     else if (nc.id != -1) { // Citizen (pero no barricada)
       if (day) return false;
-      else if (citizens[nc.id].player == pl) return false; // Never attack same clan
+      else if (citizen_by_id[nc.id]->player == pl) return false; // Never attack same clan
       else { // Night and other clan: attack but not move!!!!
-	perform_attack(ci,citizens[nc.id],killed,citizens_to_regenerate);
+	perform_attack(ci,*citizen_by_id[nc.id]);
       }
     }
     else { // Free cell, move there
-      nc.id = id;
-      oc.id = -1;
-      ci.pos = np;
+      move_citizen(ci, np);
     }    
   }
   else if (c_type == Build) {
     if (type == Warrior) {
-      //cerr << "warning: warriors cannot build." << endl;
+      //_log_warning("warriors cannot build.");
       return false;
     }
     
     if (not day) {
-      // cerr << "warning: cannot construct at night." << endl;
+      // _log_warning("cannot construct at night.");
       return false;
     }
     
     Pos np = op + dir;
     if (not pos_ok(np)) {
-      //cerr << "warning: cannot construct in position " << np << " out of the board." << endl;
+      //_log_warning("cannot construct in position " << np << " out of the board.");
       return false;
     }
 
     Cell& nc = grid[np.i][np.j];
     if (nc.type == Building or nc.bonus != NoBonus or nc.weapon != NoWeapon or nc.id != -1) {
-      //cerr << "warning: cannot construct in non-empty position " << np << endl;
+      //_log_warning("cannot construct in non-empty position " << np);
       return false;
     }
 
     if (nc.resistance != -1 and nc.b_owner != pl) {
-      //cerr << "warning: cannot construct on a rival barricade at position " << np << endl;
+      //_log_warning("cannot construct on a rival barricade at position " << np);
       return false;
     }
 
     if (oc.resistance != -1) {
-      //cerr << "warning: cannot construct from a barricade. Position " << op << endl;
+      //_log_warning("cannot construct from a barricade. Position " << op);
       return false;
     }
 
     // Trying to construct new barricade
     if (nc.resistance == -1 and  int(player2barricades[pl].size()) >= max_num_barricades()) {
-      //cerr << "warning: player " << pl << " is trying to construct more than " << max_num_barricades() << " barricades." << endl;
+      //_log_warning("player " << pl << " is trying to construct more than " << max_num_barricades() << " barricades.");
       return false;
     }
 
@@ -449,6 +446,7 @@ bool Board::execute(const Command&    m,
       nc.resistance = barricade_resistance_step();
       nc.b_owner = pl;
       player2barricades[pl].insert(np);
+      cell_changed(np);
     }
     else nc.resistance = min(nc.resistance + barricade_resistance_step(), barricade_max_resistance());
   }
@@ -457,17 +455,16 @@ bool Board::execute(const Command&    m,
 }
 
 
-void Board::kill (int id, set<int>& killed) {
+void Board::kill (int id) {
 
-  _my_assert(not killed.count(id), "Already killed");
+  Citizen* cip = find_citizen(id);
+  _my_assert(cip != nullptr, "Could not find citizen to be killed");
 
-  auto it = citizens.find(id);
-  _my_assert(it != citizens.end(), "Could not find citizen to be killed");
-
-  Citizen& ci = it->second;
+  Citizen& ci = *cip;
   int      pl = ci.player;
 
   grid[ci.pos.i][ci.pos.j].id = -1;
+  update_regen_near(ci.pos, -1);
 
   if (ci.type == Builder) {
     _my_assert(player2builders[pl].count(id), "Builder to kill is not registered.");
@@ -478,8 +475,8 @@ void Board::kill (int id, set<int>& killed) {
     player2warriors[pl].erase(id);
   }
 
-  citizens.erase(it);
-  killed.insert(id);
+  citizen_by_id[id] = nullptr;
+  citizens.erase(id);
 }
 
 bool Board::is_good_pos_to_regen ( const Pos& p) const {
@@ -495,69 +492,116 @@ bool Board::is_good_pos_to_regen ( const Pos& p) const {
 }
 
 pair<bool,Pos> Board::get_random_pos_where_regenerate ( ) {
-  vector<Pos> res;
-  for (int i = 0; i < board_rows(); ++i){
-    for (int j = 0; j < board_cols(); ++j) {
-      if (is_good_pos_to_regen(Pos(i,j))) res.push_back(Pos(i,j));
-    }
-  }
-  
-  if (res.size() != 0)  return {true,res[random(0,res.size()-1)]};
-  else                  return {false,Pos()};
+  if (num_regen_ok == 0) return {false,Pos()};
+
+  Pos p = kth_regen_pos(random(0,num_regen_ok-1));
+  _my_assert(is_good_pos_to_regen(p), "Regeneration index is out of date.");
+  return {true,p};
 }
 
-void Board::regenerate_citizens (vector<pair<pair<CitizenType,int>,int>>& to_regen) {
-  vector<pair<pair<CitizenType,int>,int>> new_to_regen;
-  for (auto p : to_regen) {
-    --p.second;
-    if (p.second == 0) { // Regenerate now
-      pair<bool,Pos> x = get_random_pos_where_regenerate();      
-      if (not x.first) {p.second = 1; new_to_regen.push_back(p);} // Regenerate next round
-      else {
-	create_new_citizen(x.second, p.first.first, p.first.second);
-      }
-    }
-    else new_to_regen.push_back(p); // To be regenerated later
-  }
-  to_regen = new_to_regen;
+void Board::init_regen_index ( ) {
+  int rows = board_rows();
+  int cols = board_cols();
+  near_citizens = vector<vector<int>>(rows, vector<int>(cols, 0));
+  regen_ok      = vector<char>(rows*cols, false);
+  regen_tree    = vector<int> (rows*cols + 1, 0);
+  num_regen_ok  = 0;
+
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      if (grid[i][j].id != -1)
+        for (int i2 = max(0, i - 2); i2 <= min(rows - 1, i + 2); ++i2)
+          for (int j2 = max(0, j - 2); j2 <= min(cols - 1, j + 2); ++j2)
+            ++near_citizens[i2][j2];
+
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      update_regen(Pos(i,j));
 }
 
-void Board::regenerate_bonus (vector<pair<BonusType,int>>& to_regen) {
-  vector<pair<BonusType,int>> new_to_regen;
-  for (auto p : to_regen) {
-    --p.second;
-    if (p.second == 0) { // Regenerate now
-      pair<bool,Pos> x = get_random_pos_where_regenerate();
-      if (not x.first) {
-	p.second = 1; new_to_regen.push_back(p);
-      } // Regenerate next round
-      else {
-	Pos pos = x.second;
-	_my_assert(grid[pos.i][pos.j].is_empty(),        "Cell is already full.");
-	grid[pos.i][pos.j].bonus = p.first;
-      }
+void Board::update_regen (const Pos& p) {
+  if (regen_ok.empty()) return;
+
+  int  k  = p.i*board_cols() + p.j;
+  bool ok = near_citizens[p.i][p.j] == 0 and grid[p.i][p.j].is_empty();
+  if (ok == bool(regen_ok[k])) return;
+
+  regen_ok[k] = ok;
+  int d = (ok ? 1 : -1);
+  num_regen_ok += d;
+  for (int x = k + 1; x < int(regen_tree.size()); x += x & -x) regen_tree[x] += d;
+}
+
+void Board::update_regen_near (const Pos& p, int d) {
+  touched.push_back(p);
+  if (regen_ok.empty()) return;
+
+  for (int i = max(0, p.i - 2); i <= min(board_rows() - 1, p.i + 2); ++i)
+    for (int j = max(0, p.j - 2); j <= min(board_cols() - 1, p.j + 2); ++j) {
+      near_citizens[i][j] += d;
+      update_regen(Pos(i,j));
     }
-    else new_to_regen.push_back(p); // To be regenerated later
-  }
-  to_regen = new_to_regen;  
 }
 
-void Board::regenerate_weapons (vector<pair<WeaponType,int>>& to_regen) {
-  vector<pair<WeaponType,int>> new_to_regen;
-  for (auto p : to_regen) {
-    --p.second;
-    if (p.second == 0) { // Regenerate now
-      pair<bool,Pos> x = get_random_pos_where_regenerate();
-      if (not x.first) {p.second = 1; new_to_regen.push_back(p);} // Regenerate next round
-      else {
-	Pos pos = x.second;
-	_my_assert(grid[pos.i][pos.j].is_empty(),        "Cell is already full.");
-	grid[pos.i][pos.j].weapon = p.first;
-      }
+Pos Board::kth_regen_pos (int k) const {
+  // Descends the Fenwick tree looking for the last prefix with at most k good positions.
+  int n = regen_tree.size() - 1;
+  int x = 0;
+  int step = 1;
+  while (2*step <= n) step *= 2;
+  for (; step > 0; step /= 2)
+    if (x + step <= n and regen_tree[x + step] <= k) {
+      x += step;
+      k -= regen_tree[x];
     }
-    else new_to_regen.push_back(p); // To be regenerated later
-  }
-  to_regen = new_to_regen;  
+  return Pos(x/board_cols(), x%board_cols());
+}
+
+void Board::cell_changed (const Pos& p) {
+  touched.push_back(p);
+  update_regen(p);
+}
+
+void Board::move_citizen (Citizen& ci, const Pos& np) {
+  Pos op = ci.pos;
+  grid[np.i][np.j].id = ci.id;
+  grid[op.i][op.j].id = -1;
+  ci.pos = np;
+  update_regen_near(op, -1);
+  update_regen_near(np,  1);
+}
+
+void Board::regenerate_citizens ( ) {
+  citizens_to_regenerate.expire([this] (const pair<CitizenType,int>& c) {
+    pair<bool,Pos> x = get_random_pos_where_regenerate();
+    if (not x.first) return false; // Regenerate next round
+    create_new_citizen(x.second, c.first, c.second);
+    return true;
+  });
+}
+
+void Board::regenerate_bonus ( ) {
+  bonus_to_regenerate.expire([this] (BonusType b) {
+    pair<bool,Pos> x = get_random_pos_where_regenerate();
+    if (not x.first) return false; // Regenerate next round
+    Pos pos = x.second;
+    _my_assert(grid[pos.i][pos.j].is_empty(),        "Cell is already full.");
+    grid[pos.i][pos.j].bonus = b;
+    cell_changed(pos);
+    return true;
+  });
+}
+
+void Board::regenerate_weapons ( ) {
+  weapons_to_regenerate.expire([this] (WeaponType w) {
+    pair<bool,Pos> x = get_random_pos_where_regenerate();
+    if (not x.first) return false; // Regenerate next round
+    Pos pos = x.second;
+    _my_assert(grid[pos.i][pos.j].is_empty(),        "Cell is already full.");
+    grid[pos.i][pos.j].weapon = w;
+    cell_changed(pos);
+    return true;
+  });
 }
 
 void Board::deteriorate_barricades ( ){
@@ -571,6 +615,7 @@ void Board::deteriorate_barricades ( ){
 	if (grid[i][j].resistance != -1) {
 	  grid[i][j].resistance = -1;
 	  grid[i][j].b_owner = -1;
+	  cell_changed(Pos(i,j));
 	}
       }
     }
@@ -580,19 +625,11 @@ void Board::deteriorate_barricades ( ){
 
 void Board::next (const vector<Action>& act, ostream& os) {
 
-  _my_assert(ok(), "Invariants are not satisfied.");
-
   int npl = num_players();
   _my_assert(int(act.size()) == npl, "Size should be number of players.");
 
-  // Elements to be regenerated
-  static vector<pair<BonusType,int>> bonus_to_regenerate; // int is rounds to wait
-  static vector<pair<WeaponType,int>> weapons_to_regenerate;
-  static vector<pair<pair<CitizenType,int>,int>> citizens_to_regenerate; // <<citizen,player>,rounds>
-
-  
   // Chooses (at most) one command per citizen.
-  set<int> seen;
+  vector<bool> seen(citizen_by_id.size(), false);
   vector<vector<Command>> v(npl);
   for (int pl = 0; pl < npl; ++pl)
     for (const Command& m : act[pl].v) {
@@ -601,20 +638,20 @@ void Board::next (const vector<Action>& act, ostream& os) {
       int dir    = m.dir;
 
 
-      auto it = citizens.find(id);
+      const Citizen* ci = find_citizen(id);
 
-      if (it == citizens.end()) {
-        //cerr << "warning: invalid id : " << id << endl;
+      if (ci == nullptr) {
+        //_log_warning("invalid id : " << id);
       }
 
-      else if (it->second.player != pl) {
-        //cerr << "warning: citizen " << id << " of player " << it->second.player
+      else if (ci->player != pl) {
+        //cerr << "warning: citizen " << id << " of player " << ci->player
 	//   << " not owned by " << pl << endl;
       }
       else {
         // Here an assert as repetitions should have already been filtered out.
-        _my_assert(not seen.count(id), "More than one command for the same citizen.");
-        seen.insert(id);
+        _my_assert(not seen[id], "More than one command for the same citizen.");
+        seen[id] = true;
 
         v[pl].push_back(Command(id, c_type, dir));
       }
@@ -627,7 +664,6 @@ void Board::next (const vector<Action>& act, ostream& os) {
   int num = 0; // Counts number of pending commands
   for (int pl = 0; pl < npl; ++pl) num += v[pl].size();
 
-  set<int> killed;
   vector<Command> commands_done;
   vector<int> index(npl, 0);
   while (num--) {
@@ -644,22 +680,73 @@ void Board::next (const vector<Action>& act, ostream& os) {
     }
 
     const Command& m = v[pl][index[pl]++];
-    if (execute(m, killed, bonus_to_regenerate, weapons_to_regenerate, citizens_to_regenerate))
+    if (execute(m))
       commands_done.push_back(m);
 
   }
   os << "commands" << endl;
   Action::print(commands_done, os);
 
-  regenerate_citizens(citizens_to_regenerate);  
-  regenerate_bonus(bonus_to_regenerate);
-  regenerate_weapons(weapons_to_regenerate);
+  regenerate_citizens();
+  regenerate_bonus();
+  regenerate_weapons();
   deteriorate_barricades();
   
   ++rnd;
   day = (rnd%(num_rounds_per_day()) < num_rounds_per_day()/2);
 
-  _my_assert(ok(), "Invariants are not satisfied.");
+  if (Check::full(rnd)) {
+    _my_assert(ok(), "Invariants are not satisfied.");
+  }
+  else if (Check::enabled()) {
+    _my_assert(touched_ok(), "Invariants of the cells touched in this round are not satisfied.");
+  }
+  touched.clear();
+}
+
+bool Board::touched_ok ( ) const {
+  for (const Pos& p : touched) {
+    const Cell& c = grid[p.i][p.j];
+
+    if (c.id != -1) {
+      auto it = citizens.find(c.id);
+      if (it == citizens.end()) {
+        cerr << "error: cell at position " << p << " has a citizen " << c.id << " that does not exist" << endl;
+        return false;
+      }
+      const Citizen& ci = it->second;
+      if (ci.pos != p) {
+        cerr << "error: citizen " << c.id << " is in cell " << p << " but thinks it is at " << ci.pos << endl;
+        return false;
+      }
+      const set<int>& s = (ci.type == Builder ? player2builders : player2warriors)[ci.player];
+      if (not s.count(c.id)) {
+        cerr << "error: citizen " << c.id << " is not registered for player " << ci.player << endl;
+        return false;
+      }
+      if (c.type == Building) {
+        cerr << "error: citizen " << c.id << " is in building cell " << p << endl;
+        return false;
+      }
+    }
+
+    if (c.resistance != -1) {
+      if (not player_ok(c.b_owner) or not player2barricades[c.b_owner].count(p)) {
+        cerr << "error: barricade at position " << p << " is not registered for its owner" << endl;
+        return false;
+      }
+    }
+    else if (c.b_owner != -1) {
+      cerr << "error: cell at position " << p << " has an owner but no barricade" << endl;
+      return false;
+    }
+
+    if (bool(regen_ok[p.i*board_cols() + p.j]) != is_good_pos_to_regen(p)) {
+      cerr << "error: regeneration index is out of date at position " << p << endl;
+      return false;
+    }
+  }
+  return true;
 }
 
 
@@ -810,10 +897,19 @@ bool Board::pos_ok_for_initial_street(const Pos& p){
 }
 
 void Board::explore_from(vector<vector<int>>& G, int i, int j, int n) {
+  // Iterative, so that large boards do not overflow the stack.
+  vector<Pos> pending(1, Pos(i,j));
   G[i][j] = n;
-  for (auto& d:{Up,Down,Left,Right}) {
-    Pos np = Pos(i,j) + d;
-    if (pos_ok(np) and G[np.i][np.j] == -1) explore_from(G,np.i,np.j,n);
+  while (not pending.empty()) {
+    Pos p = pending.back();
+    pending.pop_back();
+    for (auto& d:{Up,Down,Left,Right}) {
+      Pos np = p + d;
+      if (pos_ok(np) and G[np.i][np.j] == -1) {
+	G[np.i][np.j] = n;
+	pending.push_back(np);
+      }
+    }
   }
 }
 
@@ -839,14 +935,90 @@ int Board::num_connected_components( ){
   return n;
 }
 
+string Board::grid_key () const {
+  ostringstream oss;
+  oss << version() << " RANDOM"
+      << " players "  << num_players()
+      << " rows "     << board_rows()       << " cols "     << board_cols()
+      << " builders " << num_ini_builders() << " warriors " << num_ini_warriors()
+      << " money "    << num_ini_money()    << " food "     << num_ini_food()
+      << " guns "     << num_ini_guns()     << " bazookas " << num_ini_bazookas()
+      << " life "     << builder_ini_life() << ' '          << warrior_ini_life()
+      << " seed "     << rnd_seed;
+  return oss.str();
+}
+
+
+bool Board::load_grid (const string& key) {
+  string file = Grid_cache::file(key);
+  ifstream ifs(file);
+  string line;
+  long long seed;
+  if (not getline(ifs, line) or line != key or not (ifs >> seed)) return false;
+
+  read_grid(ifs);
+  rnd_seed = seed;
+  _log_debug("grid read from " << file);
+  return true;
+}
+
+
+void Board::store_grid (const string& key) const {
+  // Written to a temporary file first, so that other games
+  // (maybe in other processes) never read half a board.
+  string file = Grid_cache::file(key);
+  ostringstream tmp;
+  tmp << file << '.' << getpid() << '.' << this_thread::get_id();
+  ofstream ofs(tmp.str());
+  ofs << key << '\n' << rnd_seed << '\n';
+
+  ofs << "   ";
+  for (int j = 0; j < board_cols(); ++j) ofs << j / 10;
+  ofs << '\n' << "   ";
+  for (int j = 0; j < board_cols(); ++j) ofs << j % 10;
+  ofs << '\n';
+  for (int i = 0; i < board_rows(); ++i) {
+    ofs << i / 10 << i % 10 << " ";
+    for (int j = 0; j < board_cols(); ++j) {
+      const Cell& c = grid[i][j];
+      if      (c.type   == Building) ofs << 'B';
+      else if (c.weapon == Gun)      ofs << 'G';
+      else if (c.weapon == Bazooka)  ofs << 'Z';
+      else if (c.bonus  == Money)    ofs << 'M';
+      else if (c.bonus  == Food)     ofs << 'F';
+      else if (c.id     != -1)       ofs << (citizens.at(c.id).type == Builder ? 'C' : 'W');
+      else                           ofs << '.';
+    }
+    ofs << '\n';
+  }
+
+  // A generated board has no barricades yet.
+  ofs << "citizens " << citizens.size() << '\n'
+      << "type id player row column weapon life" << '\n';
+  for (const auto& p : citizens) {
+    const Citizen& ci = p.second;
+    ofs << CitizenType2char(ci.type) << ' ' << ci.id << ' ' << ci.player << ' '
+        << ci.pos.i << ' ' << ci.pos.j << ' '
+        << WeaponType2char(ci.weapon) << ' ' << ci.life << '\n';
+  }
+  ofs << "barricades 0" << '\n' << "player row column resistance" << '\n';
+  ofs.close();
+
+  if (not ofs or rename(tmp.str().c_str(), file.c_str()) != 0) {
+    _log_warning("cannot write grid to " << file);
+    remove(tmp.str().c_str());
+  }
+}
+
+
 void Board::generate_random_board ( ){
   int rows = board_rows();
   int cols = board_cols();
 
   
   // Generate buildings (leaving space for citizens)
-  static const int num_building_cells = 0.20*rows*cols; // 20% buildings
-  static const int num_streets = 5;
+  const int num_building_cells = 0.20*rows*cols; // 20% buildings
+  const int num_streets = 5;
     
   do {
     // Create grid
@@ -7,6 +7,10 @@
 #include "Info.hh"
 #include "Action.hh"
 #include "Random.hh"
+#include "Writer.hh"
+#include "TimerWheel.hh"
+#include "Check.hh"
+#include "GridCache.hh"
 
 
 /**
@@ -26,6 +30,24 @@ class Board : public Info, public Random_generator {
   vector<string> names;
   int            fresh_id;
 
+  // Elements to be regenerated, by the round at which they are due.
+  Timer_wheel<BonusType>             bonus_to_regenerate;
+  Timer_wheel<WeaponType>            weapons_to_regenerate;
+  Timer_wheel<pair<CitizenType,int>> citizens_to_regenerate; // <citizen,player>
+
+  // Citizen with each identifier, or null if it is dead. Identifiers are never
+  // reused, so a dead citizen is never mistaken for a new one. Points into
+  // citizens, which is why boards cannot be copied.
+  vector<Citizen*> citizen_by_id;
+
+  /**
+   * Returns the citizen with identifier id, or null if there is none.
+   */
+  inline Citizen* find_citizen (int id) {
+    if (id >= 0 and id < int(citizen_by_id.size())) return citizen_by_id[id];
+    else                                             return nullptr;
+  }
+
   /**
    * Checks whether initial fixed board is ok
    */
@@ -41,10 +63,34 @@ class Board : public Info, public Random_generator {
       read_grid(is);
       check_is_good_initial_fixed_board();
     }
-    else if (generator == "RANDOM") generate_random_board();
+    else if (generator == "RANDOM") {
+      string key = grid_key();
+      if (Grid_cache::enabled() and load_grid(key)) return;
+      generate_random_board();
+      if (Grid_cache::enabled()) store_grid(key);
+    }
     else                            _my_assert(false,"unknown generator  " + generator);
   }
 
+  /**
+   * Returns what determines the board built by generate_random_board:
+   * the version, the settings it uses and the state of the random generator.
+   */
+  string grid_key () const;
+
+  /**
+   * Reads the board with the given key from the grid cache, together with
+   * the state the random generator had right after generating it.
+   * Returns false if the cache does not have it.
+   */
+  bool load_grid (const string& key);
+
+  /**
+   * Writes the board to the grid cache with the given key,
+   * in the format of Info::read_grid.
+   */
+  void store_grid (const string& key) const;
+
   /**
    * Prints some information of the citizen.
    */
@@ -67,16 +113,12 @@ class Board : public Info, public Random_generator {
   /**
    * Tries to apply a move. Returns true if it could.
    */
-  bool execute(const Command&    m,
-		      set<int>&         killed,
-		      vector<pair<BonusType,int>>&   bonus_to_regenerate,
-		      vector<pair<WeaponType,int>>&  weapon_to_regenerate,
-		      vector<pair<pair<CitizenType,int>,int>>& citizens_to_regenerate
-		      );
+  bool execute(const Command&    m);
+
   /**
-   * Kill citizen with id, and add it to killed
+   * Kill citizen with id
    */
-  void kill(int id, set<int>& killed);
+  void kill(int id);
 
   /*
    * Returns whether citizen c1 wins c2 in an attack
@@ -84,24 +126,24 @@ class Board : public Info, public Random_generator {
   bool first_citizen_wins_attack(const Citizen& c1, const Citizen& c2);
 
   /* 
-   * Perfom an attack beween c1 and c2 and updates killed and citizens_to_regenerate (if some of them dies)
+   * Perfom an attack beween c1 and c2 and updates citizens_to_regenerate (if some of them dies)
    */
-  void perform_attack (Citizen& c1, Citizen& c2, set<int>& killed, vector<pair<pair<CitizenType,int>,int>>& citizens_to_regenerate);
+  void perform_attack (Citizen& c1, Citizen& c2);
 
   /*
-   * Regenerates the citizens in to_regen. Type is {{CitizenType,Player},Rounds}
+   * Regenerates the citizens due at this round. Those that find no room wait another round.
    */
-  void regenerate_citizens (vector<pair<pair<CitizenType,int>,int>>& to_regen);
+  void regenerate_citizens ( );
 
   /*
-   * Regenerates the bonus in to_regen. Type is {BonusType,Rounds}
+   * Regenerates the bonus due at this round. Those that find no room wait another round.
    */  
-  void regenerate_bonus (vector<pair<BonusType,int>>& to_regen);
+  void regenerate_bonus ( );
 
   /*
-   * Regenerates the bonus in to_regen. Type is {WeaponType,Rounds}
+   * Regenerates the weapons due at this round. Those that find no room wait another round.
    */  
-  void regenerate_weapons (vector<pair<WeaponType,int>>& to_regen);
+  void regenerate_weapons ( );
 
   /*
    * Returns whether p is an appropriate position to regenerate anb object.
@@ -115,6 +157,57 @@ class Board : public Info, public Random_generator {
    */
   pair<bool,Pos> get_random_pos_where_regenerate ( );
 
+  /////////////////////// REGENERATION INDEX ///////////////////////
+
+  // Number of citizens in the 5x5 square centered at each position.
+  vector<vector<int>> near_citizens;
+
+  // Whether each position (in row-major order) is good to regenerate,
+  // and a Fenwick tree over it, to find the k-th good position quickly.
+  vector<char> regen_ok;
+  vector<int>  regen_tree;
+  int          num_regen_ok;
+
+  /*
+   * Builds the index from the grid. Until it is built, the functions
+   * below do nothing, so the grid can be generated freely.
+   */
+  void init_regen_index ( );
+
+  /*
+   * Updates the index after the contents of position p have changed.
+   */
+  void update_regen (const Pos& p);
+
+  /*
+   * Updates the index after a citizen has arrived at (d = 1) or left (d = -1) position p,
+   * and notes p as touched.
+   */
+  void update_regen_near (const Pos& p, int d);
+
+  /*
+   * Returns the k-th (from 0) position which is good to regenerate, in row-major order.
+   */
+  Pos kth_regen_pos (int k) const;
+
+  /*
+   * Updates the index after the contents of position p have changed, and notes it as touched.
+   */
+  void cell_changed (const Pos& p);
+
+  /*
+   * Moves a citizen to an adjacent position, keeping the grid and the index.
+   */
+  void move_citizen (Citizen& ci, const Pos& np);
+
+  // Positions whose contents have changed in this round (maybe repeated).
+  vector<Pos> touched;
+
+  /*
+   * Checks the invariants that concern the touched positions only.
+   */
+  bool touched_ok ( ) const;
+
   /*
    * Called at the end of which round. Deteriorates the barricades. Currently, destroys all
    * barricades when passing from night to day.
@@ -175,7 +268,7 @@ class Board : public Info, public Random_generator {
   int num_connected_components( );
 
   /** 
-   * Auxiliary DFS to count connected components
+   * Auxiliary search to count connected components: labels with n the component of (i, j)
    */
   void explore_from(vector<vector<int>>& G, int i, int j, int n);
 
@@ -192,6 +285,9 @@ public:
    */
   Board (istream& is, int seed);
 
+  Board (const Board&) = delete;
+  Board& operator= (const Board&) = delete;
+
   /**
    * Returns the name of a player.
    */
@@ -211,9 +307,9 @@ public:
   void print_names (ostream& os) const;
 
   /**
-   * Prints the state of the board to a stream.
+   * Prints the state of the board to a writer.
    */
-  void print_state (ostream& os);
+  void print_state (Writer& os);
 
   /**
    * Prints the results and the names of the winning players.
@@ -0,0 +1,48 @@
+#ifndef Check_hh
+#define Check_hh
+
+
+/** \file
+ * How often the board invariants are checked during a game.
+ *
+ * The whole board is checked with ok() every n rounds, where n is the
+ * period set with Check::set_period(): 1 (the default) checks every round,
+ * a larger n samples one round out of n, and 0 turns checking off, as
+ * tournaments may want. Boards that know which cells a round touched
+ * check just those cells in the rounds without a full check.
+ */
+
+
+class Check {
+
+  static int& period_ () {
+    static int period = 1;
+    return period;
+  }
+
+public:
+
+  /**
+   * Sets the period. Must be called before any game starts.
+   */
+  static void set_period (int period) {
+    period_() = period;
+  }
+
+  /**
+   * Returns whether invariants are checked at all.
+   */
+  static bool enabled () {
+    return period_() > 0;
+  }
+
+  /**
+   * Returns whether the whole board must be checked after the given round.
+   */
+  static bool full (int round) {
+    return period_() > 0 and round % period_() == 0;
+  }
+};
+
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef GridCache_hh
+#define GridCache_hh
+
+
+#include "Utils.hh"
+
+
+/*! \file
+ * Contains the Grid_cache class, which keeps generated grids on disk.
+ */
+
+
+/**
+ * Directory where generated grids are kept, so that a game whose grid
+ * comes from the same generator, parameters, size and seed as an earlier
+ * one reads it instead of generating it again. Each grid is in a file
+ * named after a hash of that key, which also holds the key itself to
+ * tell collisions apart.
+ */
+class Grid_cache {
+
+  static string& dir_ () {
+    static string dir;
+    return dir;
+  }
+
+public:
+
+  /**
+   * Sets the directory, or disables the cache if dir is empty.
+   * Must be called before any game starts.
+   */
+  static void set_dir (const string& dir) {
+    dir_() = dir;
+  }
+
+  /**
+   * Returns whether the cache is enabled.
+   */
+  static bool enabled () {
+    return not dir_().empty();
+  }
+
+  /**
+   * Returns the file for the grid with the given key (64-bit FNV-1a).
+   */
+  static string file (const string& key) {
+    unsigned long long hash = 14695981039346656037ull;
+    for (char c : key) hash = (hash ^ (unsigned char)c)*1099511628211ull;
+    ostringstream oss;
+    oss << dir_() << '/' << hex << setw(16) << setfill('0') << hash << ".grid";
+    return oss.str();
+  }
+
+};
+
+
+#endif
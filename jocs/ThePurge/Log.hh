@@ -0,0 +1,138 @@
+#ifndef Log_hh
+#define Log_hh
+
+
+#include <cstdio>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+
+/** \file
+ * Leveled logging to stderr through a buffered sink.
+ *
+ * Levels below LOG_LEVEL are removed at compile time (build with
+ * -DLOG_LEVEL=LOG_WARNING, or LOG=2 in the Makefile, for tournaments).
+ * Levels below the runtime level set with Log::set_level() are discarded
+ * before the message is formatted.
+ *
+ * Messages are appended to a per-thread buffer that is written to stderr
+ * in one go when it fills up, when an error is logged, on Log::flush()
+ * and when the thread finishes.
+ */
+
+
+#define LOG_DEBUG   0
+#define LOG_INFO    1
+#define LOG_WARNING 2
+#define LOG_ERROR   3
+#define LOG_NONE    4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_INFO
+#endif
+
+
+class Log {
+
+  static const size_t CAPACITY = 1 << 16;
+
+  /**
+   * Stream buffer that appends everything to a string.
+   */
+  class Buffer : public std::streambuf {
+  public:
+    std::string data;
+  protected:
+    int_type overflow (int_type c) {
+      if (c != traits_type::eof()) data.push_back(char(c));
+      return c;
+    }
+    std::streamsize xsputn (const char* s, std::streamsize n) {
+      data.append(s, n);
+      return n;
+    }
+  };
+
+  /**
+   * Per-thread sink: a buffer and a stream writing into it.
+   */
+  struct Sink {
+    Buffer buf;
+    std::ostream os;
+
+    Sink () : os(&buf) { buf.data.reserve(CAPACITY); }
+    ~Sink () { flush(); }
+
+    void flush () {
+      if (buf.data.empty()) return;
+      fwrite(buf.data.data(), 1, buf.data.size(), stderr);
+      fflush(stderr);
+      buf.data.clear();
+    }
+  };
+
+  static Sink& sink () {
+    thread_local Sink s;
+    return s;
+  }
+
+  static int& min_level () {
+    static int level = LOG_DEBUG;
+    return level;
+  }
+
+public:
+
+  /**
+   * Sets the runtime level. Must be called before any game starts.
+   */
+  static void set_level (int level) {
+    min_level() = level;
+  }
+
+  /**
+   * Returns whether messages of the given level are printed.
+   */
+  static bool enabled (int level) {
+    return level >= LOG_LEVEL and level >= min_level();
+  }
+
+  /**
+   * Returns the stream where the current message is formatted.
+   */
+  static std::ostream& stream () {
+    return sink().os;
+  }
+
+  /**
+   * Ends the current message.
+   */
+  static void end (int level) {
+    Sink& s = sink();
+    s.buf.data.push_back('\n');
+    if (level >= LOG_ERROR or s.buf.data.size() >= CAPACITY) s.flush();
+  }
+
+  /**
+   * Writes pending messages of this thread to stderr.
+   */
+  static void flush () {
+    sink().flush();
+  }
+};
+
+
+/**
+ * Logs a message at the given level. The condition is constant
+ * when the level is below LOG_LEVEL, so the whole statement is removed.
+ */
+#define _log(level, prefix, msg) do { if (Log::enabled(level)) { Log::stream() << prefix << msg; Log::end(level); } } while (0)
+
+#define _log_debug(msg)   _log(LOG_DEBUG,   "debug: ",   msg)
+#define _log_info(msg)    _log(LOG_INFO,    "info: ",    msg)
+#define _log_warning(msg) _log(LOG_WARNING, "warning: ", msg)
+#define _log_error(msg)   _log(LOG_ERROR,   "error: ",   msg)
+
+
+#endif
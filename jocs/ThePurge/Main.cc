@@ -9,7 +9,10 @@ void help (int argc, char** argv) {
   cout << "--seed=seed     -s seed     set random seed"                   << endl;
   cout << "--input=file    -i input    set input file  (default: stdin)"  << endl;
   cout << "--output=file   -o output   set output file (default: stdout)" << endl;
+  cout << "--grids=dir     -g dir      keep generated boards in dir, to reuse them" << endl;
   cout << "--list          -l          list registered players"           << endl;
+  cout << "--quiet         -q          only log warnings and errors"      << endl;
+  cout << "--check=n       -c n        check the board every n rounds (default: 1, never: 0)" << endl;
   cout << "--version       -v          print version"                     << endl;
   cout << "--help          -h          print help"                        << endl;
 }
@@ -25,7 +28,10 @@ int main (int argc, char** argv) {
     { "seed",    required_argument, 0, 's' },
     { "input",   required_argument, 0, 'i' },
     { "output",  required_argument, 0, 'o' },
+    { "grids",   required_argument, 0, 'g' },
     { "list",    no_argument,       0, 'l' },
+    { "quiet",   no_argument,       0, 'q' },
+    { "check",   required_argument, 0, 'c' },
     { "version", no_argument,       0, 'v' },
     { "help",    no_argument,       0, 'h' },
     { 0, 0, 0, 0 }
@@ -38,7 +44,7 @@ int main (int argc, char** argv) {
 
   while (true) {
     int index = 0;
-    int c = getopt_long(argc, argv, "s:i:o:lvh", long_options, &index);
+    int c = getopt_long(argc, argv, "s:i:o:g:lqc:vh", long_options, &index);
     if (c == -1) break;
 
     switch (c) {
@@ -51,9 +57,21 @@ int main (int argc, char** argv) {
       case 'o':
         ofile = optarg;
         break;
+      case 'g':
+        Grid_cache::set_dir(optarg);
+        break;
       case 'l':
         Registry::print_players(cout);
         return EXIT_SUCCESS;
+      case 'q':
+        Log::set_level(LOG_WARNING);
+        break;
+      case 'c': {
+        int period = string_to_int(optarg);
+        _my_assert(period >= 0, "Wrong check period.");
+        Check::set_period(period);
+        break;
+      }
       case 'v':
         cout << Board::version() << endl;
         cout << "compiled " << __TIME__ << " " << __DATE__ << endl;
@@ -48,7 +48,8 @@ private:
 
   inline void reset (const Info& info) {
     *static_cast<Action*>(this) = Action();
-    *static_cast<State*>(this) = (State) info;
+    // Copied in place, reusing the memory of the previous round.
+    *static_cast<State*>(this) = static_cast<const State&>(info);
     //    forget();
   }
 
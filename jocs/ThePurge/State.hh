@@ -63,6 +63,22 @@ public:
    */
   vector<Pos> barricades(int pl) const;
 
+  /**
+   * Returns the ids of the builders of a player, without copying them.
+   */
+  const set<int>& builder_ids(int pl) const;
+
+  /**
+   * Returns the ids of the warriors of a player, without copying them.
+   */
+  const set<int>& warrior_ids(int pl) const;
+
+  /**
+   * Returns the positions of the barricades owned by a player,
+   * without copying them.
+   */
+  const set<Pos>& barricade_positions(int pl) const;
+
   /**
    * Returns the current score of a player.
    */
@@ -170,6 +186,36 @@ inline vector<Pos> State::barricades(int pl) const {
   }
 }
 
+inline const set<int>& State::builder_ids(int pl) const {
+  static const set<int> none;
+  if (pl >= 0 and pl < (int) player2builders.size())
+    return player2builders[pl];
+  else {
+    //cerr << "warning: builders requested for player " << pl << endl;
+    return none;
+  }
+}
+
+inline const set<int>& State::warrior_ids(int pl) const {
+  static const set<int> none;
+  if (pl >= 0 and pl < (int) player2warriors.size())
+    return player2warriors[pl];
+  else {
+    //cerr << "warning: warriors requested for player " << pl << endl;
+    return none;
+  }
+}
+
+inline const set<Pos>& State::barricade_positions(int pl) const {
+  static const set<Pos> none;
+  if (pl >= 0 and pl < (int) player2barricades.size())
+    return player2barricades[pl];
+  else {
+    //cerr << "warning: barricades requested for player " << pl << endl;
+    return none;
+  }
+}
+
 inline int State::score (int pl) const {
   if (pl >= 0 and pl < (int) scr.size())
     return scr[pl];
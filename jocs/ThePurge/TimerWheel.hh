@@ -0,0 +1,69 @@
+#ifndef TimerWheel_hh
+#define TimerWheel_hh
+
+
+#include "Utils.hh"
+
+
+/** \file
+ * Queue of elements that must be taken out after waiting some rounds.
+ *
+ * Elements are kept in a circular array of buckets, one per round,
+ * so that each round only deals with the elements due at that round.
+ */
+
+
+template <typename T>
+class Timer_wheel {
+
+  struct Event {
+    int seq;  // Order in which the element was added.
+    T   elem;
+  };
+
+  vector<vector<Event>> bucket; // Bucket of round r is bucket[r % size].
+  int now;       // Current round.
+  int fresh_seq;
+
+  inline void push (const Event& e, int wait) {
+    bucket[(now + wait - 1) % bucket.size()].push_back(e);
+  }
+
+public:
+
+  /**
+   * Creates an empty wheel at round 0 for waits of at most max_wait rounds.
+   */
+  Timer_wheel (int max_wait = 1)
+    : bucket(max_wait + 1), now(0), fresh_seq(0) { }
+
+  /**
+   * Adds an element that will be due after waiting wait rounds,
+   * counting the current one (so wait = 1 means the current round).
+   */
+  inline void add (const T& elem, int wait) {
+    _my_assert(wait >= 1 and wait < int(bucket.size()), "Wait is out of the wheel.");
+    push({fresh_seq++, elem}, wait);
+  }
+
+  /**
+   * Calls f on every element due at the current round, in the order in
+   * which they were added, and moves to the next round. Elements for which
+   * f returns false are due again at the next round.
+   */
+  template <typename F>
+  void expire (F f) {
+    vector<Event>& due = bucket[now % bucket.size()];
+    sort(due.begin(), due.end(), [] (const Event& a, const Event& b) {
+      return a.seq < b.seq;
+    });
+    for (const Event& e : due)
+      if (not f(e.elem)) push(e, 2);
+    due.clear();
+    ++now;
+  }
+
+};
+
+
+#endif
@@ -24,6 +24,7 @@
 #include <cmath>
 
 #include "Defs.hh"
+#include "Log.hh"
 
 using namespace std;
 
@@ -37,7 +38,7 @@ using namespace std;
 /**
  * Assert with message.
  */
-#define _my_assert(b, s) { if (not (b)) { cerr << "error: " << s << endl; assert(b); } }
+#define _my_assert(b, s) { if (not (b)) { Log::flush(); cerr << "error: " << s << endl; assert(b); } }
 
 
 /**
@@ -0,0 +1,137 @@
+#ifndef Writer_hh
+#define Writer_hh
+
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+
+
+/** \file
+ * Buffered writer for the game output.
+ *
+ * A Writer is an ostream whose text stays in a reusable byte buffer
+ * until write_to() copies it to the real output with a single write.
+ * std::endl only ends the line: it does not flush anything.
+ *
+ * Integers, characters and strings written to a Writer with << are
+ * appended directly to the buffer, without locales nor sentries.
+ * Anything else goes through the usual ostream formatting.
+ */
+
+
+class Writer : public std::ostream {
+
+  static const size_t CAPACITY = 1 << 16;
+
+  /**
+   * Stream buffer that appends everything to a string.
+   */
+  class Buffer : public std::streambuf {
+  public:
+    std::string data;
+  protected:
+    int_type overflow (int_type c) {
+      if (c != traits_type::eof()) data.push_back(char(c));
+      return c;
+    }
+    std::streamsize xsputn (const char* s, std::streamsize n) {
+      data.append(s, n);
+      return n;
+    }
+    int sync () {
+      return 0;
+    }
+  };
+
+  Buffer buf;
+
+public:
+
+  Writer () : std::ostream(&buf) {
+    buf.data.reserve(CAPACITY);
+  }
+
+  /**
+   * Appends a character.
+   */
+  void put_char (char c) {
+    buf.data.push_back(c);
+  }
+
+  /**
+   * Appends a string.
+   */
+  void put_str (const char* s) {
+    buf.data.append(s);
+  }
+
+  void put_str (const std::string& s) {
+    buf.data.append(s);
+  }
+
+  /**
+   * Appends an integer in decimal.
+   */
+  void put_int (long long x) {
+    char tmp[24];
+    int n = 0;
+    unsigned long long u = x < 0 ? -(unsigned long long)x : x;
+    do {
+      tmp[n++] = char('0' + u%10);
+      u /= 10;
+    } while (u != 0);
+    if (x < 0) buf.data.push_back('-');
+    while (n > 0) buf.data.push_back(tmp[--n]);
+  }
+
+  /**
+   * Writes the buffered text to os and empties the buffer,
+   * keeping its memory for the next round.
+   */
+  void write_to (std::ostream& os) {
+    os.write(buf.data.data(), buf.data.size());
+    buf.data.clear();
+  }
+};
+
+
+inline Writer& operator<< (Writer& w, char c) {
+  w.put_char(c);
+  return w;
+}
+
+inline Writer& operator<< (Writer& w, const char* s) {
+  w.put_str(s);
+  return w;
+}
+
+inline Writer& operator<< (Writer& w, const std::string& s) {
+  w.put_str(s);
+  return w;
+}
+
+/**
+ * Integers of any width (but not characters nor booleans).
+ */
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value and sizeof(T) != 1, Writer&>::type
+operator<< (Writer& w, T x) {
+  w.put_int(x);
+  return w;
+}
+
+/**
+ * Booleans and reals keep the ostream formatting (boolalpha, precision, etc.).
+ * Templates, so that nothing else (like manipulators) converts to them.
+ */
+template <typename T>
+inline typename std::enable_if<std::is_same<T, bool>::value or std::is_floating_point<T>::value, Writer&>::type
+operator<< (Writer& w, T x) {
+  static_cast<std::ostream&>(w) << x;
+  return w;
+}
+
+
+#endif